@@ -447,12 +447,20 @@ void VamosEditor::drawSignalFlow(juce::Graphics& g) {
     g.setFont(juce::Font(8.0f));
     g.drawText("VOICES", voiceX, voiceBaseY - 2, voiceW, 10, juce::Justification::left);
 
-    for (int i = 0; i < 8; ++i) {
-        float vx = voiceX + (float)(i % 4) * 18.0f;
-        float vy = voiceBaseY + 10.0f + (float)(i / 4) * 14.0f;
-        bool active = voices[i].isActive();
+    // Up to 8 voices: numbered 4x2 grid. Larger pools: compact 8-column grid.
+    const int numVoices = (int)voices.size();
+    const bool compact = numVoices > 8;
+    const int columns = compact ? 8 : 4;
+    const float cellW = compact ? 8.0f : 14.0f, cellH = compact ? 5.0f : 10.0f;
+    const float stepX = compact ? 9.0f : 18.0f, stepY = compact ? 7.0f : 14.0f;
+
+    for (int i = 0; i < numVoices; ++i) {
+        float vx = voiceX + (float)(i % columns) * stepX;
+        float vy = voiceBaseY + 10.0f + (float)(i / columns) * stepY;
+        bool active = voices[(size_t)i].isActive();
         g.setColour(active ? kGreen : juce::Colour(0xFF222244));
-        g.fillRoundedRectangle(vx, vy, 14, 10, 2.0f);
+        g.fillRoundedRectangle(vx, vy, cellW, cellH, compact ? 1.0f : 2.0f);
+        if (compact) continue;
         g.setColour(juce::Colours::white.withAlpha(active ? 0.9f : 0.2f));
         g.setFont(juce::Font(7.0f));
         g.drawText(juce::String(i + 1), (int)vx, (int)vy, 14, 10, juce::Justification::centred);
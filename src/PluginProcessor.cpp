@@ -25,171 +25,308 @@ static juce::StringArray voiceModeChoices() {
     return { "Poly", "Mono", "Stereo", "Unison" };
 }
 
-juce::AudioProcessorValueTreeState::ParameterLayout VamosProcessor::createParameterLayout() {
-    auto osc1 = std::make_unique<juce::AudioProcessorParameterGroup>("osc1", "Oscillator 1", "|");
+// One part's parameter groups. Part 0 keeps the original IDs; the other
+// parts' IDs and names carry their number (see partParameterId).
+static std::vector<std::unique_ptr<juce::AudioProcessorParameterGroup>> createPartGroups(int part) {
+    auto id = [part](const juce::String& paramId) { return VamosProcessor::partParameterId(part, paramId); };
+    auto name = [part](const juce::String& paramName) {
+        return part == 0 ? paramName : "P" + juce::String(part + 1) + " " + paramName;
+    };
+
+    auto osc1 = std::make_unique<juce::AudioProcessorParameterGroup>(id("osc1"), "Oscillator 1", "|");
     osc1->addChild(std::make_unique<juce::AudioParameterChoice>(
-        juce::ParameterID("osc1Type", 1), "Osc1 Type", oscType1Choices(), 0));
+        juce::ParameterID(id("osc1Type"), 1), name("Osc1 Type"), oscType1Choices(), 0));
     osc1->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("osc1Shape", 1), "Osc1 Shape",
+        juce::ParameterID(id("osc1Shape"), 1), name("Osc1 Shape"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
 
-    auto osc2 = std::make_unique<juce::AudioProcessorParameterGroup>("osc2", "Oscillator 2", "|");
+    auto osc2 = std::make_unique<juce::AudioProcessorParameterGroup>(id("osc2"), "Oscillator 2", "|");
     osc2->addChild(std::make_unique<juce::AudioParameterChoice>(
-        juce::ParameterID("osc2Type", 1), "Osc2 Type", oscType2Choices(), 2));
+        juce::ParameterID(id("osc2Type"), 1), name("Osc2 Type"), oscType2Choices(), 2));
     osc2->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("osc2Detune", 1), "Osc2 Detune",
+        juce::ParameterID(id("osc2Detune"), 1), name("Osc2 Detune"),
         juce::NormalisableRange<float>(-100.0f, 100.0f), 0.0f));
     osc2->addChild(std::make_unique<juce::AudioParameterInt>(
-        juce::ParameterID("osc2Transpose", 1), "Osc2 Transpose", -24, 24, -12));
+        juce::ParameterID(id("osc2Transpose"), 1), name("Osc2 Transpose"), -24, 24, -12));
 
-    auto mixer = std::make_unique<juce::AudioProcessorParameterGroup>("mixer", "Mixer", "|");
+    auto mixer = std::make_unique<juce::AudioProcessorParameterGroup>(id("mixer"), "Mixer", "|");
     mixer->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("osc1Gain", 1), "Osc1 Gain",
+        juce::ParameterID(id("osc1Gain"), 1), name("Osc1 Gain"),
         juce::NormalisableRange<float>(0.0f, 2.0f), 0.5f));
     mixer->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("osc2Gain", 1), "Osc2 Gain",
+        juce::ParameterID(id("osc2Gain"), 1), name("Osc2 Gain"),
         juce::NormalisableRange<float>(0.0f, 2.0f), 0.398f));
     mixer->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("noiseLevel", 1), "Noise Level",
+        juce::ParameterID(id("noiseLevel"), 1), name("Noise Level"),
         juce::NormalisableRange<float>(0.0f, 2.0f), 0.0f));
     mixer->addChild(std::make_unique<juce::AudioParameterChoice>(
-        juce::ParameterID("noiseType", 1), "Noise Type", noiseTypeChoices(), 0));
+        juce::ParameterID(id("noiseType"), 1), name("Noise Type"), noiseTypeChoices(), 0));
     mixer->addChild(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID("osc1On", 1), "Osc1 On", true));
+        juce::ParameterID(id("osc1On"), 1), name("Osc1 On"), true));
     mixer->addChild(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID("osc2On", 1), "Osc2 On", true));
+        juce::ParameterID(id("osc2On"), 1), name("Osc2 On"), true));
     mixer->addChild(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID("noiseOn", 1), "Noise On", true));
+        juce::ParameterID(id("noiseOn"), 1), name("Noise On"), true));
 
-    auto filter = std::make_unique<juce::AudioProcessorParameterGroup>("filter", "Filter", "|");
+    auto filter = std::make_unique<juce::AudioProcessorParameterGroup>(id("filter"), "Filter", "|");
     filter->addChild(std::make_unique<juce::AudioParameterChoice>(
-        juce::ParameterID("filterType", 1), "Filter Type", filterTypeChoices(), 0));
+        juce::ParameterID(id("filterType"), 1), name("Filter Type"), filterTypeChoices(), 0));
     filter->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("filterFreq", 1), "Filter Freq",
+        juce::ParameterID(id("filterFreq"), 1), name("Filter Freq"),
         juce::NormalisableRange<float>(20.0f, 20000.0f, 0.0f, 0.3f), 20000.0f));
     filter->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("filterRes", 1), "Filter Res",
+        juce::ParameterID(id("filterRes"), 1), name("Filter Res"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
     filter->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("filterTracking", 1), "Filter Tracking",
+        juce::ParameterID(id("filterTracking"), 1), name("Filter Tracking"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
 
-    auto envelope = std::make_unique<juce::AudioProcessorParameterGroup>("envelope", "Envelope", "|");
+    auto envelope = std::make_unique<juce::AudioProcessorParameterGroup>(id("envelope"), "Envelope", "|");
     envelope->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("env1Attack", 1), "Env1 Attack",
+        juce::ParameterID(id("env1Attack"), 1), name("Env1 Attack"),
         juce::NormalisableRange<float>(0.001f, 6.0f, 0.0f, 0.4f), 0.001f));
     envelope->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("env1Decay", 1), "Env1 Decay",
+        juce::ParameterID(id("env1Decay"), 1), name("Env1 Decay"),
         juce::NormalisableRange<float>(0.01f, 10.0f, 0.0f, 0.4f), 0.6f));
     envelope->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("env1Sustain", 1), "Env1 Sustain",
+        juce::ParameterID(id("env1Sustain"), 1), name("Env1 Sustain"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.7f));
     envelope->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("env1Release", 1), "Env1 Release",
+        juce::ParameterID(id("env1Release"), 1), name("Env1 Release"),
         juce::NormalisableRange<float>(0.01f, 10.0f, 0.0f, 0.4f), 0.6f));
 
-    auto lfo = std::make_unique<juce::AudioProcessorParameterGroup>("lfo", "LFO", "|");
+    auto lfo = std::make_unique<juce::AudioProcessorParameterGroup>(id("lfo"), "LFO", "|");
     lfo->addChild(std::make_unique<juce::AudioParameterChoice>(
-        juce::ParameterID("lfoShape", 1), "LFO Shape", lfoShapeChoices(), 0));
+        juce::ParameterID(id("lfoShape"), 1), name("LFO Shape"), lfoShapeChoices(), 0));
     lfo->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("lfoRate", 1), "LFO Rate",
+        juce::ParameterID(id("lfoRate"), 1), name("LFO Rate"),
         juce::NormalisableRange<float>(0.01f, 30.0f, 0.0f, 0.4f), 0.4f));
     lfo->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("lfoAmount", 1), "LFO Amount",
+        juce::ParameterID(id("lfoAmount"), 1), name("LFO Amount"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 1.0f));
 
-    auto global = std::make_unique<juce::AudioProcessorParameterGroup>("global", "Global", "|");
+    auto global = std::make_unique<juce::AudioProcessorParameterGroup>(id("global"), "Global", "|");
     global->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("volume", 1), "Volume",
+        juce::ParameterID(id("volume"), 1), name("Volume"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f));
     global->addChild(std::make_unique<juce::AudioParameterChoice>(
-        juce::ParameterID("voiceMode", 1), "Voice Mode", voiceModeChoices(), 0));
+        juce::ParameterID(id("voiceMode"), 1), name("Voice Mode"), voiceModeChoices(), 0));
+    // Unison oscillators per voice (supersaw); below 2 = 4 voices per note
+    global->addChild(std::make_unique<juce::AudioParameterInt>(
+        juce::ParameterID(id("unisonStack"), 1), name("Unison Stack"), 0, 16, 0));
     global->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("glide", 1), "Glide",
+        juce::ParameterID(id("glide"), 1), name("Glide"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.0f));
     global->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("driftDepth", 1), "Drift Depth",
+        juce::ParameterID(id("driftDepth"), 1), name("Drift Depth"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.072f));
     global->addChild(std::make_unique<juce::AudioParameterFloat>(
-        juce::ParameterID("volVelMod", 1), "Vel Mod",
+        juce::ParameterID(id("volVelMod"), 1), name("Vel Mod"),
         juce::NormalisableRange<float>(0.0f, 1.0f), 0.5f));
     global->addChild(std::make_unique<juce::AudioParameterInt>(
-        juce::ParameterID("transpose", 1), "Transpose", -24, 24, 0));
+        juce::ParameterID(id("transpose"), 1), name("Transpose"), -24, 24, 0));
     global->addChild(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID("hiQuality", 1), "Hi Quality", false));
+        juce::ParameterID(id("hiQuality"), 1), name("Hi Quality"), false));
     global->addChild(std::make_unique<juce::AudioParameterBool>(
-        juce::ParameterID("resetOscPhase", 1), "Reset Phase", false));
+        juce::ParameterID(id("resetOscPhase"), 1), name("Reset Phase"), false));
     global->addChild(std::make_unique<juce::AudioParameterInt>(
-        juce::ParameterID("pitchBendRange", 1), "Bend Range", 1, 24, 2));
+        juce::ParameterID(id("pitchBendRange"), 1), name("Bend Range"), 1, 24, 2));
+
+    std::vector<std::unique_ptr<juce::AudioProcessorParameterGroup>> groups;
+    groups.push_back(std::move(osc1));
+    groups.push_back(std::move(osc2));
+    groups.push_back(std::move(mixer));
+    groups.push_back(std::move(filter));
+    groups.push_back(std::move(envelope));
+    groups.push_back(std::move(lfo));
+    groups.push_back(std::move(global));
+    return groups;
+}
 
+juce::String VamosProcessor::partParameterId(int part, const juce::String& id) {
+    return part == 0 ? id : "p" + juce::String(part + 1) + "_" + id;
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout VamosProcessor::createParameterLayout() {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
-    layout.add(std::move(osc1));
-    layout.add(std::move(osc2));
-    layout.add(std::move(mixer));
-    layout.add(std::move(filter));
-    layout.add(std::move(envelope));
-    layout.add(std::move(lfo));
-    layout.add(std::move(global));
+    for (auto& group : createPartGroups(0))
+        layout.add(std::move(group));
+    for (int part = 1; part < kMaxParts; ++part) {
+        const juce::String number(part + 1);
+        auto partGroup = std::make_unique<juce::AudioProcessorParameterGroup>(
+            "part" + number, "Part " + number, "|");
+        for (auto& group : createPartGroups(part))
+            partGroup->addChild(std::move(group));
+        layout.add(std::move(partGroup));
+    }
     return layout;
 }
 
+// Main output plus one optional stereo output per extra part
+static juce::AudioProcessor::BusesProperties createBuses() {
+    auto buses = juce::AudioProcessor::BusesProperties()
+        .withOutput("Output", juce::AudioChannelSet::stereo(), true);
+    for (int part = 1; part < VamosProcessor::kMaxParts; ++part)
+        buses = buses.withOutput("Part " + juce::String(part + 1), juce::AudioChannelSet::stereo(), false);
+    return buses;
+}
+
 VamosProcessor::VamosProcessor()
-    : AudioProcessor(BusesProperties()
-          .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+    : AudioProcessor(createBuses()),
       apvts(*this, nullptr, "PARAMETERS", createParameterLayout())
 {
+    // Resolve the parameter IDs once; the audio thread never looks them up
+    for (int p = 0; p < kMaxParts; ++p) {
+        auto param = [this, p](const char* id) { return apvts.getRawParameterValue(partParameterId(p, id)); };
+        auto& raw = parts[static_cast<size_t>(p)].rawParams;
+        raw.osc1Type = param("osc1Type");
+        raw.osc1Shape = param("osc1Shape");
+        raw.osc2Type = param("osc2Type");
+        raw.osc2Detune = param("osc2Detune");
+        raw.osc2Transpose = param("osc2Transpose");
+        raw.osc1Gain = param("osc1Gain");
+        raw.osc2Gain = param("osc2Gain");
+        raw.noiseLevel = param("noiseLevel");
+        raw.noiseType = param("noiseType");
+        raw.osc1On = param("osc1On");
+        raw.osc2On = param("osc2On");
+        raw.noiseOn = param("noiseOn");
+        raw.filterType = param("filterType");
+        raw.filterFreq = param("filterFreq");
+        raw.filterRes = param("filterRes");
+        raw.filterTracking = param("filterTracking");
+        raw.env1Attack = param("env1Attack");
+        raw.env1Decay = param("env1Decay");
+        raw.env1Sustain = param("env1Sustain");
+        raw.env1Release = param("env1Release");
+        raw.lfoShape = param("lfoShape");
+        raw.lfoRate = param("lfoRate");
+        raw.lfoAmount = param("lfoAmount");
+        raw.volume = param("volume");
+        raw.voiceMode = param("voiceMode");
+        raw.unisonStack = param("unisonStack");
+        raw.glide = param("glide");
+        raw.driftDepth = param("driftDepth");
+        raw.volVelMod = param("volVelMod");
+        raw.transpose = param("transpose");
+        raw.resetOscPhase = param("resetOscPhase");
+        raw.pitchBendRange = param("pitchBendRange");
+    }
+
+    for (auto* param : getParameters())
+        if (auto* withId = dynamic_cast<juce::AudioProcessorParameterWithID*>(param))
+            apvts.addParameterListener(withId->paramID, this);
 }
 
-void VamosProcessor::prepareToPlay(double sampleRate, int /*samplesPerBlock*/) {
-    synth.setSampleRate(static_cast<float>(sampleRate));
+bool VamosProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const {
+    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+        return false;
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus) {
+        const auto& set = layouts.outputBuses.getReference(bus);
+        if (!set.isDisabled() && set != juce::AudioChannelSet::stereo())
+            return false;
+    }
+    return true;
+}
+
+void VamosProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
+    // Several parts share the render threads a part at a time; a single
+    // part spreads its voices over them instead
+    activeParts = getNumParts();
+    const int threads = getRenderThreads();
+    partWorkers.start(activeParts > 1 ? std::min(threads, activeParts) : 1);
+    partScratch.setSize(2 * kMaxParts, samplesPerBlock);
+    partScratchDouble.setSize(2 * kMaxParts, samplesPerBlock);
+
+    // Render at the host rate or a power-of-two fraction of it
+    const double rateLimit = isLowLatencyMode() ? 0.0 : getInternalRateLimit();
+    const int factor = vamos::Upsampler::factorFor(sampleRate, rateLimit);
+    const double engineRate = sampleRate / factor;
+    const size_t scratch = static_cast<size_t>(std::max(1, samplesPerBlock / factor + 2));
+
+    // Modulation runs at control rate: 16-sample sub-blocks at 44.1/48 kHz,
+    // scaled with the sample rate so the control rate stays around 3 kHz.
+    // Low-latency mode halves them; one tick is its micro-block.
+    const int controlBlock = (isLowLatencyMode() ? 8 : 16) * std::max(1, juce::roundToInt(engineRate / 48000.0));
+    microBlockSize = isLowLatencyMode() ? controlBlock : 0;
+    mpeMode = isMpeMode();
+
+    for (int p = 0; p < activeParts; ++p) {
+        auto& part = parts[static_cast<size_t>(p)];
+        part.channel = getPartChannel(p);
+
+        // Size the voice pool and spawn render threads here so processBlock never allocates
+        if (part.synth.getPolyphony() != getPolyphony())
+            part.synth.setPolyphony(getPolyphony());
+        part.synth.setRenderThreads(activeParts > 1 ? 1 : threads);
+
+        part.upsampler.prepare(factor);
+        part.internalLeft.assign(scratch, 0.0f);
+        part.internalRight.assign(scratch, 0.0f);
+
+        part.synth.setSampleRate(static_cast<float>(engineRate));
+        part.synth.setControlBlockSize(controlBlock);
+
+        // Render patches the lane engine supports a SIMD vector of voices at a time
+        part.synth.setLaneEngineEnabled(true);
+
+        part.smoothedVolume.reset(sampleRate, 0.02);
+        part.smoothedFilterFreq.reset(sampleRate, 0.005);
+        part.smoothedOsc1Gain.reset(sampleRate, 0.02);
+        part.smoothedOsc2Gain.reset(sampleRate, 0.02);
+        part.mpeChannels.fill({});
+    }
+    setLatencySamples(parts[0].upsampler.getLatencySamples());
 
-    smoothedVolume.reset(sampleRate, 0.02);
-    smoothedFilterFreq.reset(sampleRate, 0.005);
-    smoothedOsc1Gain.reset(sampleRate, 0.02);
-    smoothedOsc2Gain.reset(sampleRate, 0.02);
+    // Start from the current state (also picks up a restored state)
+    parametersChanged.store(true, std::memory_order_release);
 }
 
-void VamosProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
-    buffer.clear();
+void VamosProcessor::parameterChanged(const juce::String& /*parameterID*/, float /*newValue*/) {
+    parametersChanged.store(true, std::memory_order_release);
+}
 
-    // Read APVTS parameters
-    auto osc1TypeIdx = static_cast<int>(apvts.getRawParameterValue("osc1Type")->load());
-    auto osc1Shape   = apvts.getRawParameterValue("osc1Shape")->load();
-    auto osc2TypeIdx = static_cast<int>(apvts.getRawParameterValue("osc2Type")->load());
-    auto osc2Detune  = apvts.getRawParameterValue("osc2Detune")->load();
-    auto osc2Trans   = static_cast<int>(apvts.getRawParameterValue("osc2Transpose")->load());
-
-    auto osc1Gain    = apvts.getRawParameterValue("osc1Gain")->load();
-    auto osc2Gain    = apvts.getRawParameterValue("osc2Gain")->load();
-    auto noiseLevel  = apvts.getRawParameterValue("noiseLevel")->load();
-    auto noiseTypeIdx = static_cast<int>(apvts.getRawParameterValue("noiseType")->load());
-    auto osc1On      = apvts.getRawParameterValue("osc1On")->load() > 0.5f;
-    auto osc2On      = apvts.getRawParameterValue("osc2On")->load() > 0.5f;
-    auto noiseOn     = apvts.getRawParameterValue("noiseOn")->load() > 0.5f;
-
-    auto filterTypeIdx = static_cast<int>(apvts.getRawParameterValue("filterType")->load());
-    auto filterFreq    = apvts.getRawParameterValue("filterFreq")->load();
-    auto filterRes     = apvts.getRawParameterValue("filterRes")->load();
-    auto filterTrack   = apvts.getRawParameterValue("filterTracking")->load();
-
-    auto envA = apvts.getRawParameterValue("env1Attack")->load();
-    auto envD = apvts.getRawParameterValue("env1Decay")->load();
-    auto envS = apvts.getRawParameterValue("env1Sustain")->load();
-    auto envR = apvts.getRawParameterValue("env1Release")->load();
-
-    auto lfoShapeIdx = static_cast<int>(apvts.getRawParameterValue("lfoShape")->load());
-    auto lfoRate     = apvts.getRawParameterValue("lfoRate")->load();
-    auto lfoAmount   = apvts.getRawParameterValue("lfoAmount")->load();
-
-    auto volume      = apvts.getRawParameterValue("volume")->load();
-    auto voiceModeIdx = static_cast<int>(apvts.getRawParameterValue("voiceMode")->load());
-    auto glide       = apvts.getRawParameterValue("glide")->load();
-    auto driftDepth  = apvts.getRawParameterValue("driftDepth")->load();
-
-    auto volVelMod       = apvts.getRawParameterValue("volVelMod")->load();
-    auto transpose       = static_cast<int>(apvts.getRawParameterValue("transpose")->load());
-    auto resetOscPhase   = apvts.getRawParameterValue("resetOscPhase")->load() > 0.5f;
-    auto pitchBendRange  = static_cast<int>(apvts.getRawParameterValue("pitchBendRange")->load());
+void VamosProcessor::updateSynthParameters(Part& part) {
+    const auto& rawParams = part.rawParams;
+    // Read APVTS parameters through the cached pointers
+    auto osc1TypeIdx = static_cast<int>(rawParams.osc1Type->load());
+    auto osc1Shape   = rawParams.osc1Shape->load();
+    auto osc2TypeIdx = static_cast<int>(rawParams.osc2Type->load());
+    auto osc2Detune  = rawParams.osc2Detune->load();
+    auto osc2Trans   = static_cast<int>(rawParams.osc2Transpose->load());
+
+    auto osc1Gain    = rawParams.osc1Gain->load();
+    auto osc2Gain    = rawParams.osc2Gain->load();
+    auto noiseLevel  = rawParams.noiseLevel->load();
+    auto noiseTypeIdx = static_cast<int>(rawParams.noiseType->load());
+    auto osc1On      = rawParams.osc1On->load() > 0.5f;
+    auto osc2On      = rawParams.osc2On->load() > 0.5f;
+    auto noiseOn     = rawParams.noiseOn->load() > 0.5f;
+
+    auto filterTypeIdx = static_cast<int>(rawParams.filterType->load());
+    auto filterFreq    = rawParams.filterFreq->load();
+    auto filterRes     = rawParams.filterRes->load();
+    auto filterTrack   = rawParams.filterTracking->load();
+
+    auto envA = rawParams.env1Attack->load();
+    auto envD = rawParams.env1Decay->load();
+    auto envS = rawParams.env1Sustain->load();
+    auto envR = rawParams.env1Release->load();
+
+    auto lfoShapeIdx = static_cast<int>(rawParams.lfoShape->load());
+    auto lfoRate     = rawParams.lfoRate->load();
+    auto lfoAmount   = rawParams.lfoAmount->load();
+
+    auto volume      = rawParams.volume->load();
+    auto voiceModeIdx = static_cast<int>(rawParams.voiceMode->load());
+    auto unisonStack  = static_cast<int>(rawParams.unisonStack->load());
+    auto glide       = rawParams.glide->load();
+    auto driftDepth  = rawParams.driftDepth->load();
+
+    auto volVelMod       = rawParams.volVelMod->load();
+    auto transpose       = static_cast<int>(rawParams.transpose->load());
+    auto resetOscPhase   = rawParams.resetOscPhase->load() > 0.5f;
+    part.pitchBendRange  = static_cast<int>(rawParams.pitchBendRange->load());
 
     // Build parameter state for the synth
     vamos::SynthParams sp;
@@ -227,58 +364,318 @@ void VamosProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
 
     sp.driftDepth    = driftDepth;
     sp.voiceMode     = static_cast<vamos::VoiceMode>(voiceModeIdx);
+    sp.unisonStack   = unisonStack;
     // Glide parameter 0-1 maps to 0-2 seconds (exponential feel)
     sp.glideTime     = glide * 2.0f;
 
     sp.volVelMod     = volVelMod;
     sp.transpose     = transpose;
     sp.resetOscPhase = resetOscPhase;
-    sp.pitchBendRange = pitchBendRange;
+    sp.pitchBendRange = part.pitchBendRange;
 
-    synth.setParameters(sp);
+    part.synth.setParameters(sp);
 
     // Set smoothed targets
-    smoothedVolume.setTargetValue(volume);
-    smoothedFilterFreq.setTargetValue(filterFreq);
-    smoothedOsc1Gain.setTargetValue(osc1Gain);
-    smoothedOsc2Gain.setTargetValue(osc2Gain);
-
-    // Process MIDI events
-    for (const auto metadata : midiMessages) {
-        auto msg = metadata.getMessage();
-        if (msg.isNoteOn())
-            synth.noteOn(msg.getNoteNumber(), msg.getFloatVelocity());
-        else if (msg.isNoteOff())
-            synth.noteOff(msg.getNoteNumber());
-        else if (msg.isPitchWheel()) {
-            // Convert 14-bit MIDI pitch wheel (0-16383, center 8192) to semitones
-            float normalized = (msg.getPitchWheelValue() - 8192) / 8192.0f;
-            synth.setPitchBend(normalized * static_cast<float>(pitchBendRange));
+    part.smoothedVolume.setTargetValue(volume);
+    part.smoothedFilterFreq.setTargetValue(filterFreq);
+    part.smoothedOsc1Gain.setTargetValue(osc1Gain);
+    part.smoothedOsc2Gain.setTargetValue(osc2Gain);
+}
+
+void VamosProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+    render(buffer, midiMessages);
+}
+
+void VamosProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages) {
+    render(buffer, midiMessages);
+}
+
+template <typename Sample>
+void VamosProcessor::render(juce::AudioBuffer<Sample>& buffer, juce::MidiBuffer& midiMessages) {
+    buffer.clear();
+
+    // Rebuild the parameter state only after the host or the editor moved a
+    // parameter; each synth then re-derives only what those fields feed
+    if (parametersChanged.exchange(false, std::memory_order_acquire)) {
+        for (int p = 0; p < activeParts; ++p)
+            updateSynthParameters(parts[static_cast<size_t>(p)]);
+    }
+
+    const int numSamples = buffer.getNumSamples();
+    auto mainOut = getBusBuffer(buffer, false, 0);
+    Sample* mainLeft = mainOut.getWritePointer(0);
+    Sample* mainRight = mainOut.getNumChannels() > 1 ? mainOut.getWritePointer(1) : nullptr;
+
+    if (activeParts == 1) {
+        renderPart(parts[0], mainLeft, mainRight, 0, numSamples, true, midiMessages);
+        return;
+    }
+
+    // Part 0 and parts with an output bus render straight into the host's
+    // buffer; the others render into scratch and join the main mix after.
+    // A host block longer than samplesPerBlock renders in scratch-sized chunks.
+    auto& scratch = [this]() -> juce::AudioBuffer<Sample>& {
+        if constexpr (std::is_same_v<Sample, float>) return partScratch;
+        else return partScratchDouble;
+    }();
+    const int chunkSize = std::max(1, scratch.getNumSamples());
+
+    for (int start = 0; start < numSamples; start += chunkSize) {
+        const int n = std::min(chunkSize, numSamples - start);
+        PartJobs<Sample> jobs { this, &midiMessages, start, n, start + n == numSamples, {}, {} };
+        std::array<bool, kMaxParts> toMainMix {};
+        jobs.left[0] = mainLeft + start;
+        jobs.right[0] = mainRight ? mainRight + start : nullptr;
+        for (int p = 1; p < activeParts; ++p) {
+            const auto idx = static_cast<size_t>(p);
+            if (auto* bus = getBus(false, p); bus != nullptr && bus->isEnabled()) {
+                auto out = getBusBuffer(buffer, false, p);
+                jobs.left[idx] = out.getWritePointer(0) + start;
+                jobs.right[idx] = out.getNumChannels() > 1 ? out.getWritePointer(1) + start : nullptr;
+            } else {
+                jobs.left[idx] = scratch.getWritePointer(2 * p);
+                jobs.right[idx] = mainRight ? scratch.getWritePointer(2 * p + 1) : nullptr;
+                juce::FloatVectorOperations::clear(jobs.left[idx], n);
+                if (mainRight) juce::FloatVectorOperations::clear(jobs.right[idx], n);
+                toMainMix[idx] = true;
+            }
+        }
+
+        partWorkers.run(activeParts, &VamosProcessor::renderPartJob<Sample>, &jobs);
+
+        // In part order, whichever thread rendered each part
+        for (int p = 1; p < activeParts; ++p) {
+            const auto idx = static_cast<size_t>(p);
+            if (!toMainMix[idx]) continue;
+            juce::FloatVectorOperations::add(mainLeft + start, jobs.left[idx], n);
+            if (mainRight) juce::FloatVectorOperations::add(mainRight + start, jobs.right[idx], n);
+        }
+    }
+}
+
+template <typename Sample>
+void VamosProcessor::renderPartJob(void* context, int partIndex, int /*threadIndex*/) {
+    auto& jobs = *static_cast<PartJobs<Sample>*>(context);
+    const auto idx = static_cast<size_t>(partIndex);
+    jobs.self->renderPart(jobs.self->parts[idx], jobs.left[idx], jobs.right[idx],
+                          jobs.startSample, jobs.numSamples, jobs.endsBlock, *jobs.midi);
+}
+
+template <typename Sample>
+void VamosProcessor::renderPart(Part& part, Sample* leftChan, Sample* rightChan, int startSample,
+                                int numSamples, bool endsBlock, const juce::MidiBuffer& midiMessages) {
+    auto& synth = part.synth;
+    auto& upsampler = part.upsampler;
+
+    // This range's events: from startSample (or any earlier, for the first
+    // range) up to its end (or any later, for the range ending the block)
+    const auto firstEvent = startSample == 0 ? midiMessages.cbegin()
+                                             : midiMessages.findNextSamplePosition(startSample);
+    const auto lastEvent = endsBlock ? midiMessages.cend()
+                                     : midiMessages.findNextSamplePosition(startSample + numSamples);
+
+    // Nothing sounding and no events: the cleared output stays silent.
+    // The upsampler's history is below the silence threshold by now.
+    if (firstEvent == lastEvent && synth.isSilent()) {
+        part.smoothedVolume.skip(numSamples);
+        upsampler.reset();
+        return;
+    }
+
+    // Render sample-accurately: split the block at each MIDI event and
+    // render the sub-block leading up to it before applying the event.
+    // In low-latency mode an event splits the block only at a control tick.
+    int renderPos = 0;
+
+    auto renderUpTo = [&](int endPos) {
+        if (endPos <= renderPos) return;
+        if (upsampler.getFactor() == 1) {
+            synth.renderBlock(leftChan + renderPos,
+                              rightChan ? rightChan + renderPos : nullptr,
+                              endPos - renderPos);
+            renderPos = endPos;
+            return;
+        }
+        // Internal rate: events land on the nearest engine sample, and the
+        // scratch buffers bound each pass for hosts exceeding samplesPerBlock
+        const int maxPass = static_cast<int>(part.internalLeft.size() - 1) * upsampler.getFactor();
+        while (renderPos < endPos) {
+            const int n = std::min(endPos - renderPos, maxPass);
+            const int needed = upsampler.inputNeeded(n);
+            float* engineRight = rightChan ? part.internalRight.data() : nullptr;
+            synth.renderBlock(part.internalLeft.data(), engineRight, needed);
+            upsampler.process(part.internalLeft.data(), engineRight, needed,
+                              leftChan + renderPos, rightChan ? rightChan + renderPos : nullptr, n);
+            renderPos += n;
         }
-        else if (msg.isAllNotesOff() || msg.isAllSoundOff()) {
-            for (int n = 0; n < 128; ++n)
-                synth.noteOff(n);
+    };
+
+    auto eventPosition = [&](int pos) {
+        if (microBlockSize == 0)
+            return pos;
+        // Back to the last tick at or before pos; none since renderPos
+        // means the event applies where rendering stopped
+        const int tick = renderPos + synth.getSamplesToControlTick();
+        return pos < tick ? renderPos : pos - (pos - tick) % microBlockSize;
+    };
+
+    for (auto it = firstEvent; it != lastEvent; ++it) {
+        const auto metadata = *it;
+        const auto msg = metadata.getMessage();
+        if (part.channel != 0 && msg.getChannel() != part.channel)
+            continue;
+        renderUpTo(eventPosition(std::clamp(metadata.samplePosition - startSample, 0, numSamples)));
+        handleMidiEvent(part, msg);
+    }
+    renderUpTo(numSamples);
+
+    // Part volume, ramped while it moves
+    if (part.smoothedVolume.isSmoothing()) {
+        for (int i = 0; i < numSamples; ++i) {
+            const auto gain = static_cast<Sample>(part.smoothedVolume.getNextValue());
+            leftChan[i] *= gain;
+            if (rightChan) rightChan[i] *= gain;
         }
+    } else {
+        const auto gain = static_cast<Sample>(part.smoothedVolume.getTargetValue());
+        juce::FloatVectorOperations::multiply(leftChan, gain, numSamples);
+        if (rightChan) juce::FloatVectorOperations::multiply(rightChan, gain, numSamples);
     }
+}
+
+double VamosProcessor::getTailLengthSeconds() const {
+    // Read from the parameters, not the synths, which the audio thread owns
+    float release = 0.0f;
+    for (int p = 0; p < getNumParts(); ++p)
+        release = std::max(release, parts[static_cast<size_t>(p)].rawParams.env1Release->load());
+    return vamos::Synth::tailLengthSeconds(release, vamos::kDefaultSilenceThresholdDb);
+}
 
-    // Render audio
-    auto* leftChan = buffer.getWritePointer(0);
-    auto* rightChan = buffer.getNumChannels() > 1 ? buffer.getWritePointer(1) : nullptr;
-
-    for (int i = 0; i < buffer.getNumSamples(); ++i) {
-        float vol = smoothedVolume.getNextValue();
-        auto [l, r] = synth.process();
-        l *= vol;
-        r *= vol;
-        leftChan[i] = l;
-        if (rightChan) rightChan[i] = r;
+void VamosProcessor::handleMidiEvent(Part& part, const juce::MidiMessage& msg) {
+    auto& synth = part.synth;
+    // MPE member channel state, or nullptr for the master channel / no MPE
+    auto* member = mpeMode && msg.getChannel() >= 2
+        ? &part.mpeChannels[static_cast<size_t>(msg.getChannel() - 1)] : nullptr;
+
+    if (msg.isNoteOn()) {
+        const auto note = synth.noteOn(msg.getNoteNumber(), msg.getFloatVelocity());
+        if (member != nullptr) {
+            member->note = note;
+            synth.setNotePitchBend(member->note, member->bend);
+            synth.setNotePressure(member->note, member->pressure);
+            synth.setNoteSlide(member->note, member->slide);
+        }
+    }
+    else if (msg.isNoteOff()) {
+        // A member channel releases only its own note-on: another channel may
+        // hold the same note number. The handle stays, so the release tail
+        // keeps following the channel's expression.
+        if (member != nullptr && member->note.note == msg.getNoteNumber())
+            synth.noteOff(member->note);
+        else
+            synth.noteOff(msg.getNoteNumber());
+    }
+    else if (msg.isPitchWheel()) {
+        // Convert 14-bit MIDI pitch wheel (0-16383, center 8192) to semitones
+        float normalized = (msg.getPitchWheelValue() - 8192) / 8192.0f;
+        if (member != nullptr) {
+            member->bend = normalized * static_cast<float>(kMpeBendRange);
+            synth.setNotePitchBend(member->note, member->bend);
+        } else {
+            synth.setPitchBend(normalized * static_cast<float>(part.pitchBendRange));
+        }
     }
+    else if (msg.isChannelPressure()) {
+        const float pressure = msg.getChannelPressureValue() / 127.0f;
+        if (member != nullptr) {
+            member->pressure = pressure;
+            synth.setNotePressure(member->note, pressure);
+        } else {
+            synth.setPressure(pressure);
+        }
+    }
+    else if (msg.isAftertouch())
+        synth.setNotePressure(msg.getNoteNumber(), msg.getAfterTouchValue() / 127.0f);
+    else if (msg.isControllerOfType(74)) {
+        const float slide = msg.getControllerValue() / 127.0f;
+        if (member != nullptr) {
+            member->slide = slide;
+            synth.setNoteSlide(member->note, slide);
+        } else {
+            synth.setSlide(slide);
+        }
+    }
+    else if (msg.isControllerOfType(1))
+        synth.setModWheel(msg.getControllerValue() / 127.0f);
+    else if (msg.isSustainPedalOn())
+        synth.setSustainPedal(true);
+    else if (msg.isSustainPedalOff())
+        synth.setSustainPedal(false);
+    else if (msg.isAllNotesOff() || msg.isAllSoundOff())
+        synth.allNotesOff();
 }
 
 juce::AudioProcessorEditor* VamosProcessor::createEditor() {
     return new VamosEditor(*this);
 }
 
+void VamosProcessor::setPolyphony(int numVoices) {
+    apvts.state.setProperty("polyphony", std::clamp(numVoices, vamos::kMinVoices, vamos::kMaxVoices), nullptr);
+}
+
+int VamosProcessor::getPolyphony() const {
+    return static_cast<int>(apvts.state.getProperty("polyphony", vamos::kDefaultVoices));
+}
+
+void VamosProcessor::setRenderThreads(int numThreads) {
+    int maxThreads = std::max(1, juce::SystemStats::getNumCpus());
+    apvts.state.setProperty("renderThreads", std::clamp(numThreads, 1, maxThreads), nullptr);
+}
+
+int VamosProcessor::getRenderThreads() const {
+    return static_cast<int>(apvts.state.getProperty("renderThreads", 1));
+}
+
+void VamosProcessor::setInternalRateLimit(double hz) {
+    apvts.state.setProperty("internalRateLimit", std::max(0.0, hz), nullptr);
+}
+
+void VamosProcessor::setNumParts(int numParts) {
+    apvts.state.setProperty("parts", std::clamp(numParts, 1, kMaxParts), nullptr);
+}
+
+int VamosProcessor::getNumParts() const {
+    return std::clamp(static_cast<int>(apvts.state.getProperty("parts", 1)), 1, kMaxParts);
+}
+
+void VamosProcessor::setPartChannel(int part, int channel) {
+    apvts.state.setProperty("partChannel" + juce::String(part + 1), std::clamp(channel, 0, 16), nullptr);
+}
+
+int VamosProcessor::getPartChannel(int part) const {
+    return static_cast<int>(apvts.state.getProperty("partChannel" + juce::String(part + 1), 0));
+}
+
+double VamosProcessor::getInternalRateLimit() const {
+    return static_cast<double>(apvts.state.getProperty("internalRateLimit", 0.0));
+}
+
+void VamosProcessor::setLowLatencyMode(bool enabled) {
+    apvts.state.setProperty("lowLatency", enabled, nullptr);
+}
+
+bool VamosProcessor::isLowLatencyMode() const {
+    return static_cast<bool>(apvts.state.getProperty("lowLatency", false));
+}
+
+void VamosProcessor::setMpeMode(bool enabled) {
+    apvts.state.setProperty("mpe", enabled, nullptr);
+}
+
+bool VamosProcessor::isMpeMode() const {
+    return static_cast<bool>(apvts.state.getProperty("mpe", false));
+}
+
 void VamosProcessor::getStateInformation(juce::MemoryBlock& destData) {
     auto state = apvts.copyState();
     auto xml = state.createXml();
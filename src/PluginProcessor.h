@@ -1,23 +1,35 @@
 #pragma once
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "dsp/Synth.h"
+#include "dsp/Upsampler.h"
+#include "dsp/WorkerPool.h"
+#include <array>
+#include <vector>
 
-class VamosProcessor : public juce::AudioProcessor {
+class VamosProcessor : public juce::AudioProcessor,
+                       private juce::AudioProcessorValueTreeState::Listener {
 public:
     VamosProcessor();
     ~VamosProcessor() override = default;
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override {}
+    // A stereo main output; each part's extra output is stereo or disabled
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
+    // 64-bit hosts get the mix straight into their double buffers (see
+    // Synth::renderBlock); the voices still render in single precision
+    bool supportsDoublePrecisionProcessing() const override { return true; }
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override { return true; }
 
     const juce::String getName() const override { return "Vamos"; }
     bool acceptsMidi() const override { return true; }
     bool producesMidi() const override { return false; }
-    double getTailLengthSeconds() const override { return 0.0; }
+    double getTailLengthSeconds() const override;
 
     int getNumPrograms() override { return 1; }
     int getCurrentProgram() override { return 0; }
@@ -28,20 +40,168 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    const vamos::Synth& getSynth() const { return synth; }
+    // Multi-timbral parts: up to kMaxParts synth engines, each with its own
+    // parameter set and MIDI channel, rendered in parallel on a shared worker
+    // pool. Part 0 uses the plain parameter IDs and plays through the main
+    // output; part p > 0 uses partParameterId(p, id) and plays through
+    // output bus p when the host enables it, otherwise into the main mix.
+    static constexpr int kMaxParts = 4;
+    static juce::String partParameterId(int part, const juce::String& id);
+
+    // Parts playing (1..kMaxParts), saved with the plugin state. Applied at
+    // the next prepareToPlay.
+    void setNumParts(int numParts);
+    int getNumParts() const;
+
+    // MIDI channel a part listens to (1..16, 0 = all), saved with the plugin
+    // state. Applied at the next prepareToPlay.
+    void setPartChannel(int part, int channel);
+    int getPartChannel(int part) const;
+
+    const vamos::Synth& getSynth(int part = 0) const { return parts[static_cast<size_t>(part)].synth; }
+
+    // Voice pool size, saved with the plugin state. Takes effect at the next
+    // prepareToPlay -- the pool is never resized on the audio thread.
+    void setPolyphony(int numVoices);
+    int getPolyphony() const;
+
+    // Voice rendering threads (1 = audio thread only), saved with the plugin
+    // state. Like the pool size, applied at the next prepareToPlay. With
+    // several parts the threads render whole parts, one part per job.
+    void setRenderThreads(int numThreads);
+    int getRenderThreads() const;
+
+    // Highest rate the voice engine renders at, in Hz (0 = the host rate),
+    // saved with the plugin state. Above it the engine runs at the host rate
+    // divided by a power of two and is upsampled to the host rate, which adds
+    // Upsampler::getLatencySamples() of latency (reported to the host).
+    // Applied at the next prepareToPlay.
+    void setInternalRateLimit(double hz);
+    double getInternalRateLimit() const;
+
+    // Low-latency mode for live play with tiny host buffers, saved with the
+    // plugin state: modulation ticks every 8 samples (at 44.1/48 kHz) and
+    // MIDI events move back to the control tick before them, so the engine
+    // renders whole 8-sample micro-blocks however small the host block. The
+    // engine stays at the host rate (no upsampler latency). Applied at the
+    // next prepareToPlay.
+    void setLowLatencyMode(bool enabled);
+    bool isLowLatencyMode() const;
+
+    // MPE input (lower zone), saved with the plugin state. Channel 1 is the
+    // master channel. Pitch bend (kMpeBendRange semitones), channel pressure
+    // and CC74 on channels 2-16 shape only the note playing on that channel.
+    // Off, they apply to every voice. Poly aftertouch is always per note.
+    // Applied at the next prepareToPlay.
+    void setMpeMode(bool enabled);
+    bool isMpeMode() const;
+    static constexpr int kMpeBendRange = 48;
 
     juce::AudioProcessorValueTreeState apvts;
 
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
 private:
-    vamos::Synth synth;
+    // The APVTS values updateSynthParameters() reads, resolved from their IDs
+    // in the constructor so no string lookup happens on the audio thread
+    struct RawParameters {
+        // Oscillators
+        std::atomic<float> *osc1Type, *osc1Shape, *osc2Type, *osc2Detune, *osc2Transpose;
+        // Mixer
+        std::atomic<float> *osc1Gain, *osc2Gain, *noiseLevel, *noiseType, *osc1On, *osc2On,
+            *noiseOn;
+        // Filter
+        std::atomic<float> *filterType, *filterFreq, *filterRes, *filterTracking;
+        // Envelope
+        std::atomic<float> *env1Attack, *env1Decay, *env1Sustain, *env1Release;
+        // LFO
+        std::atomic<float> *lfoShape, *lfoRate, *lfoAmount;
+        // Global
+        std::atomic<float> *volume, *voiceMode, *unisonStack, *glide, *driftDepth, *volVelMod,
+            *transpose, *resetOscPhase, *pitchBendRange;
+    };
+
+    // One multi-timbral part: an engine and everything rendering it needs
+    struct Part {
+        vamos::Synth synth;
+        RawParameters rawParams {};
+        int channel = 0;         // MIDI channel, 0 = all (see setPartChannel)
+        int pitchBendRange = 2;  // semitones, refreshed from APVTS on a parameter change
+
+        // Internal-rate rendering (see setInternalRateLimit): the engine renders
+        // into the scratch buffers, the upsampler converts them to the host rate
+        vamos::Upsampler upsampler;
+        std::vector<float> internalLeft, internalRight;
+
+        // Smoothed parameters
+        juce::SmoothedValue<float> smoothedVolume { 0.5f };
+        juce::SmoothedValue<float> smoothedFilterFreq { 20000.0f };
+        juce::SmoothedValue<float> smoothedOsc1Gain { 0.5f };
+        juce::SmoothedValue<float> smoothedOsc2Gain { 0.398f };
+
+        // MPE: per member channel, the note-on it played last (its voices
+        // follow the channel until they are reused, release included) and
+        // the expression it sent last, which a note starting on it picks up
+        struct ChannelExpression {
+            vamos::NoteHandle note;
+            float bend = 0.0f;
+            float pressure = 0.0f;
+            float slide = 0.0f;
+        };
+        std::array<ChannelExpression, 16> mpeChannels {};
+    };
+
+    // processBlock() for either precision
+    template <typename Sample>
+    void render(juce::AudioBuffer<Sample>& buffer, juce::MidiBuffer& midiMessages);
+
+    // Render samples [startSample, startSample + numSamples) of one part's
+    // host block into left/right (cleared by the caller; right may be
+    // nullptr), applying the MIDI events in that range at their positions.
+    // The range that ends the block also takes events past its end.
+    template <typename Sample>
+    void renderPart(Part& part, Sample* left, Sample* right, int startSample, int numSamples,
+                    bool endsBlock, const juce::MidiBuffer& midiMessages);
+
+    // Where each part renders this block, for the part worker pool
+    template <typename Sample>
+    struct PartJobs {
+        VamosProcessor* self;
+        const juce::MidiBuffer* midi;
+        int startSample;
+        int numSamples;
+        bool endsBlock;
+        std::array<Sample*, kMaxParts> left, right;
+    };
+    template <typename Sample>
+    static void renderPartJob(void* context, int partIndex, int threadIndex);
+
+    // Apply one MIDI message to a part's synth (called at its sample position)
+    void handleMidiEvent(Part& part, const juce::MidiMessage& msg);
+
+    // Any parameter moved: processBlock() rebuilds the synths' parameters
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
+    // Read a part's APVTS parameters into its synth and smoothed values
+    void updateSynthParameters(Part& part);
+    std::atomic<bool> parametersChanged { true };
+
+    std::array<Part, kMaxParts> parts;
+    int activeParts = 1;  // getNumParts() as of the last prepareToPlay
+
+    // Renders the parts concurrently when there are several
+    vamos::WorkerPool partWorkers;
+    // Parts without an output bus of their own render here, then join the
+    // main mix in part order. Sized in prepareToPlay for every part and for
+    // samplesPerBlock; longer host blocks render in chunks of that size.
+    juce::AudioBuffer<float> partScratch;
+    juce::AudioBuffer<double> partScratchDouble;
 
-    // Smoothed parameters
-    juce::SmoothedValue<float> smoothedVolume { 0.5f };
-    juce::SmoothedValue<float> smoothedFilterFreq { 20000.0f };
-    juce::SmoothedValue<float> smoothedOsc1Gain { 0.5f };
-    juce::SmoothedValue<float> smoothedOsc2Gain { 0.398f };
+    // Low-latency mode: the control block size MIDI events are quantized to
+    // (0 = sample-accurate)
+    int microBlockSize = 0;
+    // isMpeMode() as of the last prepareToPlay
+    bool mpeMode = false;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VamosProcessor)
 };
@@ -0,0 +1,34 @@
+#pragma once
+#include <memory>
+
+namespace vamos {
+
+// A T kept on the heap with value semantics: copying a Boxed copies the T.
+// Moves large, rarely touched state out of objects that are packed in an
+// array, without giving up their default copy/move behavior.
+template <typename T>
+class Boxed {
+public:
+    Boxed() : ptr(std::make_unique<T>()) {}
+    Boxed(const Boxed& other) : ptr(std::make_unique<T>(*other.ptr)) {}
+    Boxed(Boxed&&) noexcept = default;
+
+    Boxed& operator=(const Boxed& other) {
+        if (ptr)
+            *ptr = *other.ptr;
+        else
+            ptr = std::make_unique<T>(*other.ptr);
+        return *this;
+    }
+    Boxed& operator=(Boxed&&) noexcept = default;
+
+    T* operator->() { return ptr.get(); }
+    const T* operator->() const { return ptr.get(); }
+    T& operator*() { return *ptr; }
+    const T& operator*() const { return *ptr; }
+
+private:
+    std::unique_ptr<T> ptr;
+};
+
+} // namespace vamos
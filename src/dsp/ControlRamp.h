@@ -0,0 +1,37 @@
+#pragma once
+
+namespace vamos {
+
+// Linear ramp for control-rate values that are consumed at audio rate.
+// A control tick sets a new target; next() is then called once per sample
+// and reaches the target on the last sample of the sub-block.
+struct ControlRamp {
+    float value = 0.0f;
+    float step = 0.0f;
+
+    // Jump straight to target (no interpolation)
+    void snapTo(float target) {
+        value = target;
+        step = 0.0f;
+    }
+
+    // Ramp from the current value to target over numSamples samples.
+    // A 1-sample ramp is a snap, so control block size 1 is exact.
+    void rampTo(float target, int numSamples) {
+        if (numSamples <= 1) {
+            snapTo(target);
+            return;
+        }
+        step = (target - value) / static_cast<float>(numSamples);
+    }
+
+    float next() {
+        value += step;
+        return value;
+    }
+
+    // True while the ramp sits at exactly zero (a muted gain)
+    bool isZero() const { return value == 0.0f && step == 0.0f; }
+};
+
+} // namespace vamos
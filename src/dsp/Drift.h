@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
 #include <random>
 
 namespace vamos {
@@ -30,11 +31,9 @@ public:
         // Pick a new random target periodically
         if (--counter <= 0) {
             // Random target in [-1, +1]
-            std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
-            target = dist(rng);
+            target = -1.0f + 2.0f * nextUniform();
             // Randomize next interval: 0.5 to 2.0 seconds
-            std::uniform_real_distribution<float> timeDist(0.5f, 2.0f);
-            counter = static_cast<int>(timeDist(rng) * sampleRate);
+            counter = static_cast<int>((0.5f + 1.5f * nextUniform()) * sampleRate);
         }
 
         // Smooth toward target with one-pole lowpass
@@ -45,13 +44,22 @@ public:
     }
 
 private:
+    // Uniform in [0, 1) from a xorshift32 generator (as Noise): 4 bytes of
+    // state instead of a 2.5 KB std::mt19937 in every voice
+    float nextUniform() {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        return static_cast<float>(rngState >> 8) * (1.0f / 16777216.0f);
+    }
+
     float value = 0.0f;
     float target = 0.0f;
     float rate = 0.001f;
     float sampleRate = 44100.0f;
     int counter = 0;
     int samplesPerTarget = 44100;
-    std::mt19937 rng{std::random_device{}()};
+    uint32_t rngState = std::random_device{}() | 1u;  // non-zero seed
 };
 
 } // namespace vamos
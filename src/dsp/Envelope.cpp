@@ -10,8 +10,49 @@ float Envelope::calcCoeff(float timeSeconds, float sampleRate) {
     return std::exp(-6.9f / (timeSeconds * sampleRate));
 }
 
+void Envelope::setSampleRate(float sr) {
+    if (sr == sampleRate)
+        return;
+    sampleRate = sr;
+    const bool fading = releaseCoeff != paramReleaseCoeff;
+    attackCoeff = calcCoeff(params.attack, sampleRate);
+    decayCoeff = calcCoeff(params.decay, sampleRate);
+    paramReleaseCoeff = calcCoeff(params.release, sampleRate);
+    if (!fading)
+        releaseCoeff = paramReleaseCoeff;
+    recomputes += 3;
+}
+
+void Envelope::setParams(const Params& p) {
+    if (p.attack != params.attack) {
+        attackCoeff = calcCoeff(p.attack, sampleRate);
+        ++recomputes;
+    }
+    if (p.decay != params.decay) {
+        decayCoeff = calcCoeff(p.decay, sampleRate);
+        ++recomputes;
+    }
+    if (p.release != params.release) {
+        // A fastRelease() keeps its own coefficient until the next noteOn()
+        const bool fading = releaseCoeff != paramReleaseCoeff;
+        paramReleaseCoeff = calcCoeff(p.release, sampleRate);
+        if (!fading)
+            releaseCoeff = paramReleaseCoeff;
+        ++recomputes;
+    }
+    params = p;
+}
+
 void Envelope::noteOn() {
     stage = Stage::Attack;
+    releaseCoeff = paramReleaseCoeff;
+}
+
+void Envelope::fastRelease(float coeff) {
+    if (stage == Stage::Idle)
+        return;
+    stage = Stage::Release;
+    releaseCoeff = coeff;
 }
 
 void Envelope::noteOff() {
@@ -26,7 +67,7 @@ float Envelope::process() {
 
         case Stage::Attack: {
             // Exponential attack toward 1.0
-            float coeff = calcCoeff(params.attack, sampleRate);
+            float coeff = attackCoeff;
             // Attack: exponential rise — we approach a target above 1.0 so we cross 1.0 faster
             level = 1.0f + (level - 1.0f) * coeff;
             if (level >= 0.999f) {
@@ -37,7 +78,7 @@ float Envelope::process() {
         }
 
         case Stage::Decay: {
-            float coeff = calcCoeff(params.decay, sampleRate);
+            float coeff = decayCoeff;
             level = params.sustain + (level - params.sustain) * coeff;
             if (level <= params.sustain + 0.0001f) {
                 level = params.sustain;
@@ -51,7 +92,7 @@ float Envelope::process() {
             return level;
 
         case Stage::Release: {
-            float coeff = calcCoeff(params.release, sampleRate);
+            float coeff = releaseCoeff;
             level *= coeff;
             if (level < 0.0001f) {
                 level = 0.0f;
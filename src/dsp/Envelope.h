@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
 
 namespace vamos {
 
@@ -16,23 +17,40 @@ public:
         float release = 0.6f;   // seconds
     };
 
-    void setSampleRate(float sr) { sampleRate = sr; }
-    void setParams(const Params& p) { params = p; }
+    // The stage coefficients are derived here, and only from changed inputs
+    void setSampleRate(float sr);
+    void setParams(const Params& p);
     void noteOn();
     void noteOff();
+    // Release now with coefficient coeff (see calcCoeff) instead of the
+    // release time -- a stolen voice's fade. The next noteOn() restores it.
+    void fastRelease(float coeff);
+    void reset() { stage = Stage::Idle; level = 0.0f; }  // silence immediately
     float process();
     bool isActive() const { return stage != Stage::Idle; }
     Stage getStage() const { return stage; }
     float getLevel() const { return level; }
 
-private:
+    // Coefficients derived since construction (see Synth::getCoefficientRecomputes)
+    uint32_t getCoefficientRecomputes() const { return recomputes; }
+
     // Calculate exponential coefficient for a given time constant
     static float calcCoeff(float timeSeconds, float sampleRate);
 
+private:
+    friend class VoiceLanes;
+
     Params params;
     Stage stage = Stage::Idle;
     float level = 0.0f;
     float sampleRate = 44100.0f;
+
+    // calcCoeff() of each stage time, kept in step with params and sampleRate
+    float attackCoeff = calcCoeff(Params{}.attack, 44100.0f);
+    float decayCoeff = calcCoeff(Params{}.decay, 44100.0f);
+    float paramReleaseCoeff = calcCoeff(Params{}.release, 44100.0f);
+    float releaseCoeff = paramReleaseCoeff;  // in use: differs during a fastRelease()
+    uint32_t recomputes = 0;
 };
 
 } // namespace vamos
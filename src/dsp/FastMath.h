@@ -0,0 +1,182 @@
+#pragma once
+#include "Simd.h"
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+// Build with VAMOS_FAST_MATH=0 to send the DSP blocks back to <cmath>
+#ifndef VAMOS_FAST_MATH
+  #define VAMOS_FAST_MATH 1
+#endif
+
+namespace vamos::fastmath {
+
+// ============================================================================
+// Branch-free transcendental kernels. Each one is a template over float and
+// simd::FloatV, so the scalar voice path and the voice lanes run the same
+// arithmetic; the vector width is whatever Simd.h was built for (SSE2, AVX2,
+// NEON or the scalar fallback).
+//
+// Maximum errors, measured against double-precision <cmath> over the stated
+// domains (FastMathTests.cpp checks each bound):
+//   exp2(x)    x in [-126, 126]       relative 2e-7
+//   log2(x)    x normal, positive     absolute 3e-7 * max(1, |log2 x|)
+//   sin2pi(x)  any x (turns)          absolute 3e-7
+//   sin(x)     |x| <= 2pi * 1000      absolute 7e-7 + |x| * 8e-8
+//   tan(x)     |x| <= pi/2 - 1e-3     relative 3e-7
+//   tanh(x)    any x                  absolute 2e-7
+// Outside these domains the results stay finite but lose accuracy; none of
+// them handles NaN, infinities or denormal inputs.
+// ============================================================================
+
+// Scalar counterparts of the simd:: helpers the kernels are written with
+inline float select(bool m, float a, float b) { return m ? a : b; }
+inline float min(float a, float b) { return a < b ? a : b; }
+inline float max(float a, float b) { return a > b ? a : b; }
+// Truncate and correct, as simd::floor does on SSE2: std::floor is a libm
+// call unless the target has a rounding instruction
+inline float floor(float x) {
+    float t = static_cast<float>(static_cast<int32_t>(x));
+    return t > x ? t - 1.0f : t;
+}
+inline float pow2i(float n) {
+    return std::bit_cast<float>(static_cast<int32_t>((n + 127.0f) * 8388608.0f));
+}
+inline float exponent(float x) {
+    return static_cast<float>((std::bit_cast<uint32_t>(x) & 0x7f800000u) >> 23) - 127.0f;
+}
+inline float mantissa(float x) {
+    return std::bit_cast<float>((std::bit_cast<uint32_t>(x) & 0x007fffffu) | 0x3f800000u);
+}
+
+template <typename T>
+inline T abs(T x) { return max(x, T(0.0f) - x); }
+
+// 2^x: split off the nearest integer, a degree-6 polynomial for the
+// fraction in [-0.5, 0.5], then scale by the integer power of two
+template <typename T>
+inline T exp2(T x) {
+    x = min(T(126.0f), max(T(-126.0f), x));
+    T n = floor(x + T(0.5f));
+    T f = x - n;
+    T p = T(1.535336188319500e-4f);
+    p = T(1.339887440266574e-3f) + f * p;
+    p = T(9.618437357674640e-3f) + f * p;
+    p = T(5.550332471162809e-2f) + f * p;
+    p = T(2.402264791363012e-1f) + f * p;
+    p = T(6.931472028550421e-1f) + f * p;
+    return (T(1.0f) + f * p) * pow2i(n);
+}
+
+// log2(x) for positive normal x: exponent plus log2 of the mantissa,
+// folded into [sqrt(1/2), sqrt(2)) and expanded as 2 atanh(t) / ln 2
+template <typename T>
+inline T log2(T x) {
+    T e = exponent(x);
+    T m = mantissa(x);
+    auto high = m > T(std::numbers::sqrt2_v<float>);
+    m = select(high, m * T(0.5f), m);
+    e = select(high, e + T(1.0f), e);
+    T t = (m - T(1.0f)) / (m + T(1.0f));
+    T t2 = t * t;
+    constexpr float k = 2.0f / std::numbers::ln2_v<float>;
+    T p = T(k / 9.0f);
+    p = T(k / 7.0f) + t2 * p;
+    p = T(k / 5.0f) + t2 * p;
+    p = T(k / 3.0f) + t2 * p;
+    p = T(k) + t2 * p;
+    return e + t * p;
+}
+
+// sin(2 pi x), x in turns: fold to a quarter turn, then an odd Taylor
+// polynomial (truncation error 6e-8 at the fold edge)
+template <typename T>
+inline T sin2pi(T x) {
+    x = x - floor(x) - T(0.5f); // sin(2pi*x) = -sin(2pi*(x - 1/2))
+    x = select(x > T(0.25f), T(0.5f) - x, x);
+    x = select(x < T(-0.25f), T(-0.5f) - x, x);
+    T t = T(2.0f * std::numbers::pi_v<float>) * x;
+    T t2 = t * t;
+    T p = T(-1.0f / 39916800.0f);
+    p = T(1.0f / 362880.0f) + t2 * p;
+    p = T(-1.0f / 5040.0f) + t2 * p;
+    p = T(1.0f / 120.0f) + t2 * p;
+    p = T(-1.0f / 6.0f) + t2 * p;
+    p = T(1.0f) + t2 * p;
+    return T(0.0f) - t * p;
+}
+
+// sin(x), x in radians
+template <typename T>
+inline T sin(T x) {
+    return sin2pi(x * T(0.5f * std::numbers::inv_pi_v<float>));
+}
+
+// tan(x): reduce by multiples of pi into [-pi/2, pi/2], fold the outer
+// half through tan(x) = 1 / tan(pi/2 - x), then a minimax polynomial on
+// [0, pi/4]
+template <typename T>
+inline T tan(T x) {
+    T k = floor(x * T(std::numbers::inv_pi_v<float>) + T(0.5f));
+    // pi split in two so k * pi stays exact for the first term
+    T y = x - k * T(3.140625f) - k * T(9.67653589793e-4f);
+    T a = abs(y);
+    auto outer = a > T(0.25f * std::numbers::pi_v<float>);
+    // pi/2 split the same way, so pi/2 - a keeps its precision near the pole
+    T z = select(outer, (T(1.5703125f) - a) + T(4.83826794897e-4f), a);
+    T z2 = z * z;
+    T p = T(9.38540185543e-3f);
+    p = T(3.11992232697e-3f) + z2 * p;
+    p = T(2.44301354525e-2f) + z2 * p;
+    p = T(5.34112807005e-2f) + z2 * p;
+    p = T(1.33387994085e-1f) + z2 * p;
+    p = T(3.33331568548e-1f) + z2 * p;
+    T r = z + z * z2 * p;
+    r = select(outer, T(1.0f) / r, r);
+    return select(y < T(0.0f), T(0.0f) - r, r);
+}
+
+// tanh(x): an odd minimax polynomial below |x| = 0.625, where the exp form
+// cancels, and 1 - 2 / (e^2|x| + 1) above it
+template <typename T>
+inline T tanh(T x) {
+    T a = abs(x);
+    T x2 = x * x;
+    T p = T(-5.70498872745e-3f);
+    p = T(2.06390887954e-2f) + x2 * p;
+    p = T(-5.37397155531e-2f) + x2 * p;
+    p = T(1.33314422036e-1f) + x2 * p;
+    p = T(-3.33332819422e-1f) + x2 * p;
+    T small = x + x * x2 * p;
+    T e = exp2(min(a, T(20.0f)) * T(2.0f * std::numbers::log2e_v<float>));
+    T large = T(1.0f) - T(2.0f) / (e + T(1.0f));
+    large = select(x < T(0.0f), T(0.0f) - large, large);
+    return select(a < T(0.625f), small, large);
+}
+
+} // namespace vamos::fastmath
+
+namespace vamos::math {
+
+// ============================================================================
+// What the scalar DSP blocks call: the fastmath kernels by default, <cmath>
+// when built with VAMOS_FAST_MATH=0 (for A/B listening and reference renders).
+// The voice lanes always use the kernels; they have no <cmath> equivalent.
+// ============================================================================
+
+#if VAMOS_FAST_MATH
+inline float exp2(float x) { return fastmath::exp2(x); }
+inline float log2(float x) { return fastmath::log2(x); }
+inline float sin2pi(float x) { return fastmath::sin2pi(x); }
+inline float tan(float x) { return fastmath::tan(x); }
+inline float tanh(float x) { return fastmath::tanh(x); }
+#else
+inline float exp2(float x) { return std::exp2(x); }
+inline float log2(float x) { return std::log2(x); }
+inline float sin2pi(float x) { return std::sin(2.0f * std::numbers::pi_v<float> * x); }
+inline float tan(float x) { return std::tan(x); }
+inline float tanh(float x) { return std::tanh(x); }
+#endif
+
+} // namespace vamos::math
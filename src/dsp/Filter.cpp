@@ -19,10 +19,13 @@ static constexpr float kVowelFormants[5][3] = {
 
 void Filter::setSampleRate(float sr) {
     sampleRate = sr;
+    prewarpCutoff = 0.0f;  // g depends on the sample rate
 
     // Allocate comb buffer: max delay for 20 Hz at current sample rate
     int maxDelay = static_cast<int>(sr / 20.0f) + 1;
     combBuffer.resize(maxDelay, 0.0f);
+    combWritePos = 0;
+    combWritten = 0;
 }
 
 void Filter::reset() {
@@ -36,8 +39,11 @@ void Filter::reset() {
     vowelBp2.reset();
     vowelBp3.reset();
 
-    std::fill(combBuffer.begin(), combBuffer.end(), 0.0f);
+    // The comb buffer is cleared lazily: slots not written since the reset
+    // read as zero (see processComb), so a note-on costs the same at any
+    // sample rate instead of sr / 20 stores
     combWritePos = 0;
+    combWritten = 0;
 
     resampleHoldValue = 0.0f;
     resampleCounter = 0.0f;
@@ -45,81 +51,18 @@ void Filter::reset() {
     hiPassX1 = 0.0f;
 }
 
-float Filter::applyTracking(float baseCutoff, int midiNote) const {
-    if (params.tracking <= 0.0f || midiNote < 0)
-        return baseCutoff;
-
-    // Keyboard tracking: shift cutoff relative to middle C (MIDI 60)
-    // Full tracking (1.0): cutoff follows pitch exactly
-    float semitoneOffset = params.tracking * static_cast<float>(midiNote - 60);
-    return baseCutoff * std::pow(2.0f, semitoneOffset / 12.0f);
-}
-
 float Filter::process(float osc1, float osc2, float noiseSample, int midiNote) {
-    // Compute effective cutoff with keyboard tracking
-    float cutoff = applyTracking(params.frequency, midiNote);
-    cutoff = std::clamp(cutoff, 20.0f, 20000.0f);
-
-    // Split signal into filtered and bypassed paths based on Through params
-    float toFilter = 0.0f;
-    float bypassed = 0.0f;
-
-    if (params.oscThrough1)
-        toFilter += osc1;
-    else
-        bypassed += osc1;
-
-    if (params.oscThrough2)
-        toFilter += osc2;
-    else
-        bypassed += osc2;
-
-    if (params.noiseThrough)
-        toFilter += noiseSample;
-    else
-        bypassed += noiseSample;
-
-    // Apply the selected filter type
-    float filtered = 0.0f;
     switch (params.type) {
-        case FilterType::I:          filtered = processTypeI(toFilter, cutoff); break;
-        case FilterType::II:         filtered = processTypeII(toFilter, cutoff); break;
-        case FilterType::LowPass:    filtered = processLowPass(toFilter, cutoff); break;
-        case FilterType::HighPass:   filtered = processHighPass(toFilter, cutoff); break;
-        case FilterType::Comb:       filtered = processComb(toFilter, cutoff); break;
-        case FilterType::Vowel:      filtered = processVowel(toFilter, cutoff); break;
-        case FilterType::DJ:         filtered = processDJ(toFilter, cutoff); break;
-        case FilterType::Resampling: filtered = processResampling(toFilter, cutoff); break;
+        case FilterType::I:          return processAs<FilterType::I>(osc1, osc2, noiseSample, midiNote);
+        case FilterType::II:         return processAs<FilterType::II>(osc1, osc2, noiseSample, midiNote);
+        case FilterType::LowPass:    return processAs<FilterType::LowPass>(osc1, osc2, noiseSample, midiNote);
+        case FilterType::HighPass:   return processAs<FilterType::HighPass>(osc1, osc2, noiseSample, midiNote);
+        case FilterType::Comb:       return processAs<FilterType::Comb>(osc1, osc2, noiseSample, midiNote);
+        case FilterType::Vowel:      return processAs<FilterType::Vowel>(osc1, osc2, noiseSample, midiNote);
+        case FilterType::DJ:         return processAs<FilterType::DJ>(osc1, osc2, noiseSample, midiNote);
+        case FilterType::Resampling: return processAs<FilterType::Resampling>(osc1, osc2, noiseSample, midiNote);
     }
-
-    // Combine filtered and bypassed
-    float output = filtered + bypassed;
-
-    // Apply secondary high-pass filter
-    output = processHiPass(output);
-
-    return output;
-}
-
-float Filter::processTypeI(float input, float cutoff) {
-    // Single Sallen-Key stage: 12dB/oct, gentle and warm
-    return sallenKey1.process(input, cutoff, params.resonance, sampleRate);
-}
-
-float Filter::processTypeII(float input, float cutoff) {
-    // Two cascaded Sallen-Key stages: 24dB/oct, aggressive
-    float stage1 = sallenKey2a.process(input, cutoff, params.resonance, sampleRate);
-    return sallenKey2b.process(stage1, cutoff, params.resonance, sampleRate);
-}
-
-float Filter::processLowPass(float input, float cutoff) {
-    auto out = svf.process(input, cutoff, params.resonance, sampleRate);
-    return out.lp;
-}
-
-float Filter::processHighPass(float input, float cutoff) {
-    auto out = svf.process(input, cutoff, params.resonance, sampleRate);
-    return out.hp;
+    return 0.0f;
 }
 
 float Filter::processComb(float input, float cutoff) {
@@ -139,13 +82,18 @@ float Filter::processComb(float input, float cutoff) {
     int readPos2 = readPos1 - 1;
     if (readPos2 < 0) readPos2 += static_cast<int>(combBuffer.size());
 
-    float delayed = combBuffer[readPos1] * (1.0f - frac) + combBuffer[readPos2] * frac;
+    // Writes since the reset fill the buffer from slot 0 up, so slot i holds
+    // a sample of this note iff i < combWritten
+    float tap1 = readPos1 < combWritten ? combBuffer[readPos1] : 0.0f;
+    float tap2 = readPos2 < combWritten ? combBuffer[readPos2] : 0.0f;
+    float delayed = tap1 * (1.0f - frac) + tap2 * frac;
 
     // Resonance controls feedback amount (0 = no feedback, 1 = high feedback)
     float feedback = params.resonance * 0.95f; // cap below 1.0 for stability
 
     combBuffer[combWritePos] = input + delayed * feedback;
     combWritePos++;
+    combWritten = std::max(combWritten, combWritePos);
     if (combWritePos >= static_cast<int>(combBuffer.size()))
         combWritePos = 0;
 
@@ -158,10 +106,10 @@ float Filter::processVowel(float input, float cutoff) {
 
     // Map cutoff (20-20000) to vowel position (0-4)
     // Use log scale for more even distribution
-    float logMin = std::log(20.0f);
-    float logMax = std::log(20000.0f);
-    float logCutoff = std::log(std::clamp(cutoff, 20.0f, 20000.0f));
-    float vowelPos = (logCutoff - logMin) / (logMax - logMin) * 4.0f;
+    constexpr float kLogMin = 4.32192809f;     // log2(20)
+    constexpr float kLogMax = 14.28771238f;    // log2(20000)
+    float logCutoff = math::log2(std::clamp(cutoff, 20.0f, 20000.0f));
+    float vowelPos = (logCutoff - kLogMin) * (4.0f / (kLogMax - kLogMin));
     vowelPos = std::clamp(vowelPos, 0.0f, 3.999f);
 
     // Interpolate between two adjacent vowels
@@ -221,25 +169,4 @@ float Filter::processResampling(float input, float cutoff) {
     return resampleHoldValue;
 }
 
-float Filter::processHiPass(float input) {
-    // 1-pole high-pass filter for the secondary HP
-    // Bypassed when frequency is at minimum (10 Hz)
-    if (params.hiPassFrequency <= 10.0f)
-        return input;
-
-    float freq = std::clamp(params.hiPassFrequency, 10.0f, 20000.0f);
-
-    // 1-pole HP: y[n] = alpha * (y[n-1] + x[n] - x[n-1])
-    // alpha = RC / (RC + dt), where RC = 1/(2*pi*freq), dt = 1/sampleRate
-    float rc = 1.0f / (2.0f * std::numbers::pi_v<float> * freq);
-    float dt = 1.0f / sampleRate;
-    float alpha = rc / (rc + dt);
-
-    float y = alpha * (hiPassY1 + input - hiPassX1);
-    hiPassX1 = input;
-    hiPassY1 = y;
-
-    return y;
-}
-
 } // namespace vamos
@@ -1,8 +1,10 @@
 #pragma once
+#include "FastMath.h"
 #include <cmath>
 #include <numbers>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
 
 namespace vamos {
 
@@ -35,10 +37,17 @@ public:
     void reset() { s1 = 0.0f; s2 = 0.0f; }
 
     float process(float input, float cutoffHz, float resonance, float sampleRate) {
-        // Clamp cutoff to safe range
+        return processPrewarped(input, prewarp(cutoffHz, sampleRate), resonance);
+    }
+
+    // Prewarped cutoff coefficient g, clamped to a safe range
+    static float prewarp(float cutoffHz, float sampleRate) {
         cutoffHz = std::clamp(cutoffHz, 20.0f, sampleRate * 0.49f);
+        return math::tan(std::numbers::pi_v<float> * cutoffHz / sampleRate);
+    }
 
-        float g = std::tan(std::numbers::pi_v<float> * cutoffHz / sampleRate);
+    // process() with g = prewarp(cutoffHz, sampleRate) computed by the caller
+    float processPrewarped(float input, float g, float resonance) {
         // Resonance: 0 = no resonance, 1 = max resonance
         // k: 2 (no res) down to 0 (self-oscillation)
         float k = 2.0f * (1.0f - resonance);
@@ -54,12 +63,14 @@ public:
         s2 = 2.0f * lp - s2;
 
         // MS-20 saturation: tanh on the feedback path state
-        s1 = std::tanh(s1);
+        s1 = math::tanh(s1);
 
         return lp;
     }
 
 private:
+    friend class VoiceLanes;
+
     float s1 = 0.0f;
     float s2 = 0.0f;
 };
@@ -73,9 +84,11 @@ public:
     struct Output { float lp; float hp; float bp; };
 
     Output process(float input, float cutoffHz, float resonance, float sampleRate) {
-        cutoffHz = std::clamp(cutoffHz, 20.0f, sampleRate * 0.49f);
+        return processPrewarped(input, SallenKeyFilter::prewarp(cutoffHz, sampleRate), resonance);
+    }
 
-        float g = std::tan(std::numbers::pi_v<float> * cutoffHz / sampleRate);
+    // process() with g = SallenKeyFilter::prewarp(cutoffHz, sampleRate)
+    Output processPrewarped(float input, float g, float resonance) {
         float k = 2.0f * (1.0f - resonance);  // damping
 
         float a1 = 1.0f / (1.0f + g * (g + k));
@@ -97,6 +110,8 @@ public:
     }
 
 private:
+    friend class VoiceLanes;
+
     float ic1eq = 0.0f;
     float ic2eq = 0.0f;
 };
@@ -114,9 +129,27 @@ public:
     // Returns the combined output (filtered + bypassed).
     float process(float osc1, float osc2, float noiseSample, int midiNote);
 
+    // process() with the filter type fixed at compile time (Type must be
+    // params.type), for Voice's patch kernels
+    template <FilterType Type>
+    float processAs(float osc1, float osc2, float noiseSample, int midiNote);
+
+    // Coefficients derived since construction (see Synth::getCoefficientRecomputes)
+    uint32_t getCoefficientRecomputes() const { return recomputes; }
+
+    // Exchange the comb delay line's storage (not its positions) with
+    // storage, without copying samples (see Voice::takeOver)
+    void swapDelayLine(std::vector<float>& storage) { combBuffer.swap(storage); }
+
 private:
+    friend class VoiceLanes;
+
     // Apply keyboard tracking to cutoff
-    float applyTracking(float baseCutoff, int midiNote) const;
+    float applyTracking(float baseCutoff, int midiNote);
+
+    // Prewarped coefficient for the Sallen-Key/SVF types, recomputed only
+    // when the cutoff moves (it holds still whenever its ramp does)
+    float prewarpedCutoff(float cutoff);
 
     // Individual filter type processors
     float processTypeI(float input, float cutoff);
@@ -151,6 +184,7 @@ private:
     // Comb filter delay buffer
     std::vector<float> combBuffer;
     int combWritePos = 0;
+    int combWritten = 0;    // slots [0, combWritten) written since reset()
 
     // Vowel filter: 3 parallel bandpass SVFs
     StateVariableFilter vowelBp1;
@@ -164,6 +198,132 @@ private:
     // Secondary high-pass (1-pole) state
     float hiPassY1 = 0.0f;
     float hiPassX1 = 0.0f;
+
+    // Derived coefficients and the inputs they were computed from
+    float trackingRatio = 1.0f;     // 2^(tracking * (note - 60) / 12)
+    float trackedAmount = 0.0f;
+    int trackedNote = 60;
+    float prewarpCutoff = 0.0f;     // 0 = not computed yet
+    float prewarpG = 0.0f;
+    uint32_t recomputes = 0;
 };
 
+// ============================================================================
+// Per-sample path, inline for processAs(). The less common types (Comb,
+// Vowel, DJ, Resampling) stay out of line in Filter.cpp.
+// ============================================================================
+
+template <FilterType Type>
+inline float Filter::processAs(float osc1, float osc2, float noiseSample, int midiNote) {
+    // Compute effective cutoff with keyboard tracking
+    float cutoff = applyTracking(params.frequency, midiNote);
+    cutoff = std::clamp(cutoff, 20.0f, 20000.0f);
+
+    // Split signal into filtered and bypassed paths based on Through params
+    float toFilter = 0.0f;
+    float bypassed = 0.0f;
+
+    if (params.oscThrough1)
+        toFilter += osc1;
+    else
+        bypassed += osc1;
+
+    if (params.oscThrough2)
+        toFilter += osc2;
+    else
+        bypassed += osc2;
+
+    if (params.noiseThrough)
+        toFilter += noiseSample;
+    else
+        bypassed += noiseSample;
+
+    // Apply the selected filter type
+    float filtered;
+    if constexpr (Type == FilterType::I)             filtered = processTypeI(toFilter, cutoff);
+    else if constexpr (Type == FilterType::II)       filtered = processTypeII(toFilter, cutoff);
+    else if constexpr (Type == FilterType::LowPass)  filtered = processLowPass(toFilter, cutoff);
+    else if constexpr (Type == FilterType::HighPass) filtered = processHighPass(toFilter, cutoff);
+    else if constexpr (Type == FilterType::Comb)     filtered = processComb(toFilter, cutoff);
+    else if constexpr (Type == FilterType::Vowel)    filtered = processVowel(toFilter, cutoff);
+    else if constexpr (Type == FilterType::DJ)       filtered = processDJ(toFilter, cutoff);
+    else                                             filtered = processResampling(toFilter, cutoff);
+
+    // Combine filtered and bypassed
+    float output = filtered + bypassed;
+
+    // Apply secondary high-pass filter
+    output = processHiPass(output);
+
+    return output;
+}
+
+inline float Filter::applyTracking(float baseCutoff, int midiNote) {
+    if (params.tracking <= 0.0f || midiNote < 0)
+        return baseCutoff;
+
+    // Keyboard tracking: shift cutoff relative to middle C (MIDI 60)
+    // Full tracking (1.0): cutoff follows pitch exactly
+    if (params.tracking != trackedAmount || midiNote != trackedNote) {
+        trackedAmount = params.tracking;
+        trackedNote = midiNote;
+        float semitoneOffset = params.tracking * static_cast<float>(midiNote - 60);
+        trackingRatio = math::exp2(semitoneOffset / 12.0f);
+        ++recomputes;
+    }
+    return baseCutoff * trackingRatio;
+}
+
+inline float Filter::prewarpedCutoff(float cutoff) {
+    if (cutoff != prewarpCutoff) {
+        prewarpCutoff = cutoff;
+        prewarpG = SallenKeyFilter::prewarp(cutoff, sampleRate);
+        ++recomputes;
+    }
+    return prewarpG;
+}
+
+inline float Filter::processTypeI(float input, float cutoff) {
+    // Single Sallen-Key stage: 12dB/oct, gentle and warm
+    return sallenKey1.processPrewarped(input, prewarpedCutoff(cutoff), params.resonance);
+}
+
+inline float Filter::processTypeII(float input, float cutoff) {
+    // Two cascaded Sallen-Key stages: 24dB/oct, aggressive
+    const float g = prewarpedCutoff(cutoff);
+    float stage1 = sallenKey2a.processPrewarped(input, g, params.resonance);
+    return sallenKey2b.processPrewarped(stage1, g, params.resonance);
+}
+
+inline float Filter::processLowPass(float input, float cutoff) {
+    auto out = svf.processPrewarped(input, prewarpedCutoff(cutoff), params.resonance);
+    return out.lp;
+}
+
+inline float Filter::processHighPass(float input, float cutoff) {
+    auto out = svf.processPrewarped(input, prewarpedCutoff(cutoff), params.resonance);
+    return out.hp;
+}
+
+inline float Filter::processHiPass(float input) {
+    // 1-pole high-pass filter for the secondary HP
+    // Bypassed when frequency is at minimum (10 Hz)
+    if (params.hiPassFrequency <= 10.0f)
+        return input;
+
+    float freq = std::clamp(params.hiPassFrequency, 10.0f, 20000.0f);
+
+    // 1-pole HP: y[n] = alpha * (y[n-1] + x[n] - x[n-1])
+    // alpha = RC / (RC + dt), where RC = 1/(2*pi*freq), dt = 1/sampleRate
+    float rc = 1.0f / (2.0f * std::numbers::pi_v<float> * freq);
+    float dt = 1.0f / sampleRate;
+    float alpha = rc / (rc + dt);
+
+    float y = alpha * (hiPassY1 + input - hiPassX1);
+    hiPassX1 = input;
+    hiPassY1 = y;
+
+    return y;
+}
+
 } // namespace vamos
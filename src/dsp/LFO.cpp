@@ -1,4 +1,5 @@
 #include "LFO.h"
+#include "FastMath.h"
 #include <cmath>
 #include <numbers>
 
@@ -25,7 +26,7 @@ void LFO::noteOn() {
 }
 
 float LFO::generateSine(float phase) {
-    return std::sin(2.0f * std::numbers::pi_v<float> * phase);
+    return math::sin2pi(phase);
 }
 
 float LFO::generateTriangle(float phase) {
@@ -56,13 +57,18 @@ float LFO::generateSampleAndHold(float phase, bool wrapped) {
 float LFO::generateWander() {
     // Smooth random walk: low-pass filtered random noise
     float noise = generateRandom();
-    float smoothing = 1.0f - std::exp(-2.0f * std::numbers::pi_v<float> * rate / sampleRate);
-    wanderValue += smoothing * (noise - wanderValue);
+    const float normalizedRate = rate / sampleRate;
+    if (normalizedRate != wanderRate) {
+        wanderRate = normalizedRate;
+        wanderSmoothing = 1.0f - std::exp(-2.0f * std::numbers::pi_v<float> * normalizedRate);
+        ++recomputes;
+    }
+    wanderValue += wanderSmoothing * (noise - wanderValue);
     return wanderValue;
 }
 
 float LFO::generateExponentialEnv(float phase) {
-    return std::exp(-phase * 6.0f);
+    return math::exp2(-phase * (6.0f * std::numbers::log2e_v<float>));
 }
 
 float LFO::process() {
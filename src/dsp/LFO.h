@@ -31,6 +31,9 @@ public:
     float getAmount() const { return amount; }
     bool getRetrigger() const { return retrigger; }
 
+    // Coefficients derived since construction (see Synth::getCoefficientRecomputes)
+    uint32_t getCoefficientRecomputes() const { return recomputes; }
+
     // Reset phase (called on note-on when retrigger is enabled)
     void reset();
 
@@ -62,8 +65,12 @@ private:
     // Sample & Hold state
     float shValue = 0.0f;
 
-    // Wander state: filtered random walk
+    // Wander state: filtered random walk, smoothed with a one-pole at the
+    // LFO rate (coefficient recomputed when the rate or sample rate moves)
     float wanderValue = 0.0f;
+    float wanderSmoothing = 0.0f;
+    float wanderRate = 0.0f;        // rate / sampleRate the coefficient is for
+    uint32_t recomputes = 0;
     uint32_t rngState = 0xDEADBEEF;
 
     float generateRandom();
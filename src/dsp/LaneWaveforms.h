@@ -0,0 +1,60 @@
+#pragma once
+#include "FastMath.h"
+#include "Oscillator.h"
+#include "Simd.h"
+
+namespace vamos::simd {
+
+// ============================================================================
+// Branch-free SIMD waveforms shared by the voice-lane engine and the unison
+// oscillator stack: one oscillator per lane, phase and increment per lane.
+// ============================================================================
+
+// Same polynomial as Oscillator::polyBlep, written as selects
+inline FloatV laneBlep(FloatV t, FloatV dt) {
+    const FloatV one(1.0f);
+    FloatV x1 = t / dt;
+    FloatV after = x1 + x1 - x1 * x1 - one;
+    FloatV x2 = (t - one) / dt;
+    FloatV before = x2 * x2 + x2 + x2 + one;
+    return select(t < dt, after, select(t > one - dt, before, FloatV(0.0f)));
+}
+
+inline FloatV laneSaw(FloatV phase, FloatV dt, FloatV shape) {
+    FloatV saw = FloatV(2.0f) * phase - FloatV(1.0f) - laneBlep(phase, dt);
+    FloatV tri = select(phase > FloatV(0.5f),
+                        FloatV(3.0f) - FloatV(4.0f) * phase,
+                        FloatV(4.0f) * phase - FloatV(1.0f));
+    return select(shape > FloatV(0.0f), saw * (FloatV(1.0f) - shape) + tri * shape, saw);
+}
+
+inline FloatV laneRectangle(FloatV phase, FloatV dt, FloatV shape) {
+    const FloatV one(1.0f);
+    FloatV pw = FloatV(0.5f) + shape * FloatV(0.49f);
+    FloatV square = select(phase < pw, one, FloatV(-1.0f)) + laneBlep(phase, dt);
+    FloatV shifted = phase + (one - pw);
+    shifted = select(shifted >= one, shifted - one, shifted);
+    return square - laneBlep(shifted, dt);
+}
+
+// sin(2*pi*phase): the shared fast-math kernel, as Oscillator::generateSine
+inline FloatV laneSine(FloatV phase) { return fastmath::sin2pi(phase); }
+
+template <OscillatorType1 Type>
+inline FloatV laneOscillator(FloatV phase, FloatV dt, FloatV shape) {
+    if constexpr (Type == OscillatorType1::Saw)
+        return laneSaw(phase, dt, shape);
+    else if constexpr (Type == OscillatorType1::Rectangle)
+        return laneRectangle(phase, dt, shape);
+    else
+        return laneSine(phase);
+}
+
+// True for the waveforms laneOscillator() implements
+inline bool isLaneOscillator(OscillatorType1 type) {
+    return type == OscillatorType1::Saw
+        || type == OscillatorType1::Rectangle
+        || type == OscillatorType1::Sine;
+}
+
+} // namespace vamos::simd
@@ -0,0 +1,137 @@
+#include "OscillatorStack.h"
+#include "LaneWaveforms.h"
+#include <algorithm>
+#include <cmath>
+
+namespace vamos {
+
+void OscillatorStack::setSampleRate(float sr) {
+    sampleRate = sr;
+    for (auto& osc : scalarOscs)
+        osc.setSampleRate(sr);
+}
+
+void OscillatorStack::setType(OscillatorType1 t) {
+    type = t;
+    for (auto& osc : scalarOscs)
+        osc.setType(t);
+}
+
+void OscillatorStack::configure(int newSize, float spreadCents) {
+    newSize = newSize >= 2 ? std::min(newSize, kMaxSize) : 0;
+    if (newSize == size && spreadCents == spread)
+        return;
+    size = newSize;
+    spread = spreadCents;
+    gainL.fill(0.0f);
+    gainR.fill(0.0f);
+    ratio.fill(1.0f);
+    if (size == 0)
+        return;
+
+    // Same spread as Unison mode's voices, generalized from 4 copies to N
+    const float centre = 0.5f * static_cast<float>(size - 1);
+    const float norm = 1.0f / std::sqrt(static_cast<float>(size));
+    for (int k = 0; k < size; ++k) {
+        float offset = static_cast<float>(k) - centre;
+        float pan = offset / (0.5f * static_cast<float>(size));
+        ratio[k] = std::pow(2.0f, offset * spreadCents / 1200.0f);
+        gainL[k] = (1.0f - pan) * norm;
+        gainR[k] = (1.0f + pan) * norm;
+    }
+}
+
+void OscillatorStack::resetPhases() {
+    // Golden-ratio sequence: evenly spread for any size, the same every note
+    constexpr float kGolden = 0.618034f;
+    for (int k = 0; k < kMaxSize; ++k) {
+        float p = static_cast<float>(k) * kGolden;
+        phase[k] = p - std::floor(p);
+        scalarOscs[k].phasor.reset(phase[k]);
+    }
+}
+
+void OscillatorStack::render(const float* freqHz, const float* shape, float* left, float* right, int numSamples) {
+    switch (type) {
+        case OscillatorType1::Saw:       renderLanes<OscillatorType1::Saw>(freqHz, shape, left, right, numSamples); break;
+        case OscillatorType1::Rectangle: renderLanes<OscillatorType1::Rectangle>(freqHz, shape, left, right, numSamples); break;
+        case OscillatorType1::Sine:      renderLanes<OscillatorType1::Sine>(freqHz, shape, left, right, numSamples); break;
+        default:                         renderScalar(freqHz, shape, left, right, numSamples); break;
+    }
+}
+
+void OscillatorStack::advance(const float* freqHz, int numSamples) {
+    if (!simd::isLaneOscillator(type)) {
+        for (int k = 0; k < size; ++k) {
+            Oscillator& osc = scalarOscs[k];
+            for (int i = 0; i < numSamples; ++i) {
+                osc.setFrequency(freqHz[i] * ratio[k]);
+                osc.advance();
+            }
+        }
+        return;
+    }
+    const float invRate = 1.0f / sampleRate;
+    for (int k = 0; k < size; ++k) {
+        float p = phase[k];
+        for (int i = 0; i < numSamples; ++i) {
+            p += freqHz[i] * invRate * ratio[k];
+            if (p >= 1.0f) p -= 1.0f;
+        }
+        phase[k] = p;
+    }
+}
+
+template <OscillatorType1 Type>
+void OscillatorStack::renderLanes(const float* freqHz, const float* shape, float* left, float* right, int numSamples) {
+    using simd::FloatV;
+    constexpr int kMaxVectors = kMaxSize / kWidth;
+    const int numVectors = (size + kWidth - 1) / kWidth;
+
+    FloatV ph[kMaxVectors], rt[kMaxVectors], gl[kMaxVectors], gr[kMaxVectors];
+    for (int v = 0; v < numVectors; ++v) {
+        ph[v] = FloatV::load(phase.data() + v * kWidth);
+        rt[v] = FloatV::load(ratio.data() + v * kWidth);
+        gl[v] = FloatV::load(gainL.data() + v * kWidth);
+        gr[v] = FloatV::load(gainR.data() + v * kWidth);
+    }
+
+    const float invRate = 1.0f / sampleRate;
+    const FloatV one(1.0f);
+    for (int i = 0; i < numSamples; ++i) {
+        const FloatV inc(freqHz[i] * invRate);
+        const FloatV sh(shape[i]);
+        FloatV accL(0.0f), accR(0.0f);
+        for (int v = 0; v < numVectors; ++v) {
+            FloatV dt = inc * rt[v];
+            FloatV out = simd::laneOscillator<Type>(ph[v], dt, sh);
+            FloatV next = ph[v] + dt;
+            ph[v] = simd::select(next >= one, next - one, next);
+            accL = accL + out * gl[v];
+            accR = accR + out * gr[v];
+        }
+        left[i] = simd::hsum(accL);
+        right[i] = simd::hsum(accR);
+    }
+
+    for (int v = 0; v < numVectors; ++v)
+        ph[v].store(phase.data() + v * kWidth);
+}
+
+void OscillatorStack::renderScalar(const float* freqHz, const float* shape, float* left, float* right, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+        float l = 0.0f, r = 0.0f;
+        for (int k = 0; k < size; ++k) {
+            Oscillator& osc = scalarOscs[k];
+            osc.setFrequency(freqHz[i] * ratio[k]);
+            osc.setShape(shape[i]);
+            float out = osc.process();
+            l += out * gainL[k];
+            r += out * gainR[k];
+        }
+        left[i] = l;
+        right[i] = r;
+    }
+}
+
+} // namespace vamos
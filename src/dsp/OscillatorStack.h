@@ -0,0 +1,67 @@
+#pragma once
+#include "Oscillator.h"
+#include "Simd.h"
+#include <array>
+
+namespace vamos {
+
+// Unison oscillator stack (supersaw) for one voice.
+//
+// Up to kMaxSize detuned copies of oscillator 1, spread like Unison mode's
+// voices: copy k of N sits (k - (N-1)/2) * spreadCents from the played pitch
+// and is panned (k - (N-1)/2) / (N/2) across the stereo field. The copies are
+// rendered simd::FloatV::size at a time with the lane engine's PolyBLEP
+// waveforms (Saw, Rectangle, Sine) and summed into a left/right pair, so a
+// single voice -- one filter pair, one envelope, one set of modulators --
+// carries the whole stack. Other waveforms use scalar Oscillators.
+class OscillatorStack {
+public:
+    static constexpr int kMaxSize = 16;
+
+    void setSampleRate(float sr);
+    void setType(OscillatorType1 type);
+
+    // size copies (2..kMaxSize, 0 or 1 = off) spaced spreadCents apart.
+    // Recomputes the ratios and pan gains only when either changed, so
+    // calling it on every note-on costs a comparison.
+    void configure(int size, float spreadCents);
+    int getSize() const { return size; }
+
+    // Spread the copies' start phases evenly, so the stack does not start
+    // with every copy in phase (an audible click and comb sweep)
+    void resetPhases();
+
+    // Render numSamples into left/right (overwriting). freqHz[i] and shape[i]
+    // are the played pitch and osc1 shape at sample i. Each channel is the
+    // copies' sum weighted by 1 -/+ pan, normalized by 1/sqrt(size) so the
+    // stack keeps about one oscillator's loudness.
+    void render(const float* freqHz, const float* shape, float* left, float* right, int numSamples);
+
+    // Advance the copies' phases by numSamples without rendering (osc1 muted)
+    void advance(const float* freqHz, int numSamples);
+
+private:
+    template <OscillatorType1 Type>
+    void renderLanes(const float* freqHz, const float* shape, float* left, float* right, int numSamples);
+    void renderScalar(const float* freqHz, const float* shape, float* left, float* right, int numSamples);
+
+    static constexpr int kWidth = simd::FloatV::size;
+    static_assert(kMaxSize % kWidth == 0);
+
+    OscillatorType1 type = OscillatorType1::Saw;
+    float sampleRate = 44100.0f;
+    int size = 0;
+    float spread = 0.0f;    // cents, as last configured
+
+    // Per copy: phase in [0, 1), frequency ratio to the played pitch and
+    // channel weights (zero for unused copies)
+    alignas(32) std::array<float, kMaxSize> phase{};
+    alignas(32) std::array<float, kMaxSize> ratio{};
+    alignas(32) std::array<float, kMaxSize> gainL{};
+    alignas(32) std::array<float, kMaxSize> gainR{};
+
+    // Waveforms without a lane implementation
+    std::array<Oscillator, kMaxSize> scalarOscs{};
+};
+
+} // namespace vamos
@@ -0,0 +1,246 @@
+#pragma once
+
+#if defined(__AVX__)
+  #include <immintrin.h>
+  #define VAMOS_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define VAMOS_SIMD_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  #include <arm_neon.h>
+  #define VAMOS_SIMD_NEON 1
+#else
+  #include <array>
+  #include <bit>
+  #include <cmath>
+  #include <cstdint>
+  #define VAMOS_SIMD_SCALAR 1
+#endif
+
+namespace vamos::simd {
+
+// Minimal float vector for the voice-lane engine: one lane per voice.
+//   AVX:  8 lanes (__m256), when the DSP layer is built with -mavx2
+//   SSE2: 4 lanes (__m128), the x86-64 baseline
+//   NEON: 4 lanes (float32x4_t), arm64
+//   Scalar fallback: 4 lanes in a plain array
+// Comparisons return a Mask; select(mask, a, b) picks a where mask is set.
+// hsum(x) adds up the lanes of x.
+//
+// Bit-level helpers for the fast-math kernels (FastMath.h):
+//   floor(x):    round toward -inf, for |x| < 2^31
+//   pow2i(n):    2^n for integral n in [-126, 127], built in the exponent field
+//   exponent(x): unbiased exponent of a positive normal x, as a float
+//   mantissa(x): x scaled by a power of two into [1, 2)
+
+#if VAMOS_SIMD_AVX
+
+struct Mask { __m256 m; };
+
+struct FloatV {
+    static constexpr int size = 8;
+    __m256 v;
+
+    FloatV() : v(_mm256_setzero_ps()) {}
+    FloatV(__m256 x) : v(x) {}
+    FloatV(float x) : v(_mm256_set1_ps(x)) {}
+
+    static FloatV load(const float* p) { return _mm256_load_ps(p); }
+    void store(float* p) const { _mm256_store_ps(p, v); }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return _mm256_add_ps(a.v, b.v); }
+    friend FloatV operator-(FloatV a, FloatV b) { return _mm256_sub_ps(a.v, b.v); }
+    friend FloatV operator*(FloatV a, FloatV b) { return _mm256_mul_ps(a.v, b.v); }
+    friend FloatV operator/(FloatV a, FloatV b) { return _mm256_div_ps(a.v, b.v); }
+    friend Mask operator<(FloatV a, FloatV b)  { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+    friend Mask operator>(FloatV a, FloatV b)  { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+    friend Mask operator<=(FloatV a, FloatV b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LE_OQ) }; }
+    friend Mask operator>=(FloatV a, FloatV b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+    friend Mask operator==(FloatV a, FloatV b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_EQ_OQ) }; }
+};
+
+inline Mask operator&(Mask a, Mask b) { return { _mm256_and_ps(a.m, b.m) }; }
+inline Mask operator|(Mask a, Mask b) { return { _mm256_or_ps(a.m, b.m) }; }
+inline FloatV select(Mask m, FloatV a, FloatV b) { return _mm256_blendv_ps(b.v, a.v, m.m); }
+inline FloatV min(FloatV a, FloatV b) { return _mm256_min_ps(a.v, b.v); }
+inline FloatV max(FloatV a, FloatV b) { return _mm256_max_ps(a.v, b.v); }
+inline float hsum(FloatV a) {
+    __m128 x = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+    x = _mm_add_ps(x, _mm_movehl_ps(x, x));
+    x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 1));
+    return _mm_cvtss_f32(x);
+}
+inline FloatV floor(FloatV a) { return _mm256_floor_ps(a.v); }
+inline FloatV pow2i(FloatV n) {
+    __m256 biased = _mm256_mul_ps(_mm256_add_ps(n.v, _mm256_set1_ps(127.0f)), _mm256_set1_ps(8388608.0f));
+    return _mm256_castsi256_ps(_mm256_cvttps_epi32(biased));
+}
+inline FloatV exponent(FloatV a) {
+    __m256 bits = _mm256_and_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7f800000)));
+    __m256 biased = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_castps_si256(bits)), _mm256_set1_ps(1.0f / 8388608.0f));
+    return _mm256_sub_ps(biased, _mm256_set1_ps(127.0f));
+}
+inline FloatV mantissa(FloatV a) {
+    __m256 bits = _mm256_and_ps(a.v, _mm256_castsi256_ps(_mm256_set1_epi32(0x007fffff)));
+    return _mm256_or_ps(bits, _mm256_set1_ps(1.0f));
+}
+
+#elif VAMOS_SIMD_SSE2
+
+struct Mask { __m128 m; };
+
+struct FloatV {
+    static constexpr int size = 4;
+    __m128 v;
+
+    FloatV() : v(_mm_setzero_ps()) {}
+    FloatV(__m128 x) : v(x) {}
+    FloatV(float x) : v(_mm_set1_ps(x)) {}
+
+    static FloatV load(const float* p) { return _mm_load_ps(p); }
+    void store(float* p) const { _mm_store_ps(p, v); }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return _mm_add_ps(a.v, b.v); }
+    friend FloatV operator-(FloatV a, FloatV b) { return _mm_sub_ps(a.v, b.v); }
+    friend FloatV operator*(FloatV a, FloatV b) { return _mm_mul_ps(a.v, b.v); }
+    friend FloatV operator/(FloatV a, FloatV b) { return _mm_div_ps(a.v, b.v); }
+    friend Mask operator<(FloatV a, FloatV b)  { return { _mm_cmplt_ps(a.v, b.v) }; }
+    friend Mask operator>(FloatV a, FloatV b)  { return { _mm_cmpgt_ps(a.v, b.v) }; }
+    friend Mask operator<=(FloatV a, FloatV b) { return { _mm_cmple_ps(a.v, b.v) }; }
+    friend Mask operator>=(FloatV a, FloatV b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+    friend Mask operator==(FloatV a, FloatV b) { return { _mm_cmpeq_ps(a.v, b.v) }; }
+};
+
+inline Mask operator&(Mask a, Mask b) { return { _mm_and_ps(a.m, b.m) }; }
+inline Mask operator|(Mask a, Mask b) { return { _mm_or_ps(a.m, b.m) }; }
+inline FloatV select(Mask m, FloatV a, FloatV b) {
+    return _mm_or_ps(_mm_and_ps(m.m, a.v), _mm_andnot_ps(m.m, b.v));
+}
+inline FloatV min(FloatV a, FloatV b) { return _mm_min_ps(a.v, b.v); }
+inline FloatV max(FloatV a, FloatV b) { return _mm_max_ps(a.v, b.v); }
+inline float hsum(FloatV a) {
+    __m128 x = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+    x = _mm_add_ss(x, _mm_shuffle_ps(x, x, 1));
+    return _mm_cvtss_f32(x);
+}
+inline FloatV floor(FloatV a) {
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f)));
+}
+inline FloatV pow2i(FloatV n) {
+    __m128 biased = _mm_mul_ps(_mm_add_ps(n.v, _mm_set1_ps(127.0f)), _mm_set1_ps(8388608.0f));
+    return _mm_castsi128_ps(_mm_cvttps_epi32(biased));
+}
+inline FloatV exponent(FloatV a) {
+    __m128 bits = _mm_and_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(0x7f800000)));
+    __m128 biased = _mm_mul_ps(_mm_cvtepi32_ps(_mm_castps_si128(bits)), _mm_set1_ps(1.0f / 8388608.0f));
+    return _mm_sub_ps(biased, _mm_set1_ps(127.0f));
+}
+inline FloatV mantissa(FloatV a) {
+    __m128 bits = _mm_and_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(0x007fffff)));
+    return _mm_or_ps(bits, _mm_set1_ps(1.0f));
+}
+
+#elif VAMOS_SIMD_NEON
+
+struct Mask { uint32x4_t m; };
+
+struct FloatV {
+    static constexpr int size = 4;
+    float32x4_t v;
+
+    FloatV() : v(vdupq_n_f32(0.0f)) {}
+    FloatV(float32x4_t x) : v(x) {}
+    FloatV(float x) : v(vdupq_n_f32(x)) {}
+
+    static FloatV load(const float* p) { return vld1q_f32(p); }
+    void store(float* p) const { vst1q_f32(p, v); }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return vaddq_f32(a.v, b.v); }
+    friend FloatV operator-(FloatV a, FloatV b) { return vsubq_f32(a.v, b.v); }
+    friend FloatV operator*(FloatV a, FloatV b) { return vmulq_f32(a.v, b.v); }
+    friend FloatV operator/(FloatV a, FloatV b) { return vdivq_f32(a.v, b.v); }
+    friend Mask operator<(FloatV a, FloatV b)  { return { vcltq_f32(a.v, b.v) }; }
+    friend Mask operator>(FloatV a, FloatV b)  { return { vcgtq_f32(a.v, b.v) }; }
+    friend Mask operator<=(FloatV a, FloatV b) { return { vcleq_f32(a.v, b.v) }; }
+    friend Mask operator>=(FloatV a, FloatV b) { return { vcgeq_f32(a.v, b.v) }; }
+    friend Mask operator==(FloatV a, FloatV b) { return { vceqq_f32(a.v, b.v) }; }
+};
+
+inline Mask operator&(Mask a, Mask b) { return { vandq_u32(a.m, b.m) }; }
+inline Mask operator|(Mask a, Mask b) { return { vorrq_u32(a.m, b.m) }; }
+inline FloatV select(Mask m, FloatV a, FloatV b) { return vbslq_f32(m.m, a.v, b.v); }
+inline FloatV min(FloatV a, FloatV b) { return vminq_f32(a.v, b.v); }
+inline FloatV max(FloatV a, FloatV b) { return vmaxq_f32(a.v, b.v); }
+inline float hsum(FloatV a) { return vaddvq_f32(a.v); }
+inline FloatV floor(FloatV a) { return vrndmq_f32(a.v); }
+inline FloatV pow2i(FloatV n) {
+    float32x4_t biased = vmulq_f32(vaddq_f32(n.v, vdupq_n_f32(127.0f)), vdupq_n_f32(8388608.0f));
+    return vreinterpretq_f32_s32(vcvtq_s32_f32(biased));
+}
+inline FloatV exponent(FloatV a) {
+    uint32x4_t bits = vandq_u32(vreinterpretq_u32_f32(a.v), vdupq_n_u32(0x7f800000));
+    float32x4_t biased = vmulq_f32(vcvtq_f32_u32(bits), vdupq_n_f32(1.0f / 8388608.0f));
+    return vsubq_f32(biased, vdupq_n_f32(127.0f));
+}
+inline FloatV mantissa(FloatV a) {
+    uint32x4_t bits = vandq_u32(vreinterpretq_u32_f32(a.v), vdupq_n_u32(0x007fffff));
+    return vreinterpretq_f32_u32(vorrq_u32(bits, vdupq_n_u32(0x3f800000)));
+}
+
+#else // VAMOS_SIMD_SCALAR
+
+struct Mask { std::array<bool, 4> m{}; };
+
+struct FloatV {
+    static constexpr int size = 4;
+    std::array<float, 4> v{};
+
+    FloatV() = default;
+    FloatV(float x) : v{ x, x, x, x } {}
+
+    static FloatV load(const float* p) { FloatV r; for (int i = 0; i < 4; ++i) r.v[i] = p[i]; return r; }
+    void store(float* p) const { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+
+    template <typename Op>
+    static FloatV map(FloatV a, FloatV b, Op op) { FloatV r; for (int i = 0; i < 4; ++i) r.v[i] = op(a.v[i], b.v[i]); return r; }
+    template <typename Op>
+    static Mask test(FloatV a, FloatV b, Op op) { Mask r; for (int i = 0; i < 4; ++i) r.m[i] = op(a.v[i], b.v[i]); return r; }
+
+    friend FloatV operator+(FloatV a, FloatV b) { return map(a, b, [](float x, float y) { return x + y; }); }
+    friend FloatV operator-(FloatV a, FloatV b) { return map(a, b, [](float x, float y) { return x - y; }); }
+    friend FloatV operator*(FloatV a, FloatV b) { return map(a, b, [](float x, float y) { return x * y; }); }
+    friend FloatV operator/(FloatV a, FloatV b) { return map(a, b, [](float x, float y) { return x / y; }); }
+    friend Mask operator<(FloatV a, FloatV b)  { return test(a, b, [](float x, float y) { return x < y; }); }
+    friend Mask operator>(FloatV a, FloatV b)  { return test(a, b, [](float x, float y) { return x > y; }); }
+    friend Mask operator<=(FloatV a, FloatV b) { return test(a, b, [](float x, float y) { return x <= y; }); }
+    friend Mask operator>=(FloatV a, FloatV b) { return test(a, b, [](float x, float y) { return x >= y; }); }
+    friend Mask operator==(FloatV a, FloatV b) { return test(a, b, [](float x, float y) { return x == y; }); }
+};
+
+inline Mask operator&(Mask a, Mask b) { Mask r; for (int i = 0; i < 4; ++i) r.m[i] = a.m[i] && b.m[i]; return r; }
+inline Mask operator|(Mask a, Mask b) { Mask r; for (int i = 0; i < 4; ++i) r.m[i] = a.m[i] || b.m[i]; return r; }
+inline FloatV select(Mask m, FloatV a, FloatV b) { FloatV r; for (int i = 0; i < 4; ++i) r.v[i] = m.m[i] ? a.v[i] : b.v[i]; return r; }
+inline FloatV min(FloatV a, FloatV b) { return FloatV::map(a, b, [](float x, float y) { return x < y ? x : y; }); }
+inline FloatV max(FloatV a, FloatV b) { return FloatV::map(a, b, [](float x, float y) { return x > y ? x : y; }); }
+inline float hsum(FloatV a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+template <typename Op>
+inline FloatV mapLanes(FloatV a, Op op) { FloatV r; for (int i = 0; i < 4; ++i) r.v[i] = op(a.v[i]); return r; }
+inline FloatV floor(FloatV a) { return mapLanes(a, [](float x) { return std::floor(x); }); }
+inline FloatV pow2i(FloatV n) {
+    return mapLanes(n, [](float x) { return std::bit_cast<float>(static_cast<int32_t>((x + 127.0f) * 8388608.0f)); });
+}
+inline FloatV exponent(FloatV a) {
+    return mapLanes(a, [](float x) {
+        return static_cast<float>((std::bit_cast<uint32_t>(x) & 0x7f800000u) >> 23) - 127.0f;
+    });
+}
+inline FloatV mantissa(FloatV a) {
+    return mapLanes(a, [](float x) {
+        return std::bit_cast<float>((std::bit_cast<uint32_t>(x) & 0x007fffffu) | 0x3f800000u);
+    });
+}
+
+#endif
+
+} // namespace vamos::simd
@@ -1,49 +1,255 @@
 #include "Synth.h"
-#include <limits>
 #include <cmath>
+#include <algorithm>
 
 namespace vamos {
 
+template <typename Fn>
+void Synth::forEachVoice(Fn&& fn) {
+    for (auto& v : voices)
+        fn(v);
+    for (auto& v : ghosts)
+        fn(v);
+}
+
+template <typename Fn>
+void Synth::forEachNoteVoice(int midiNote, Fn&& fn) {
+    if (voiceMode == VoiceMode::Mono) {
+        if (voices[0].isActive() && voices[0].getCurrentNote() == midiNote)
+            fn(voices[0]);
+        return;
+    }
+    const int size = allocator.getSlotSize();
+    allocator.forEachHeldSlot(midiNote, [&](int slot) {
+        for (int i = 0; i < size; ++i)
+            fn(voices[slot * size + i]);
+    });
+}
+
+template <typename Fn>
+void Synth::forEachHandleVoice(const NoteHandle& note, Fn&& fn) {
+    if (voiceMode == VoiceMode::Mono || note.slot < 0) {
+        forEachNoteVoice(note.note, fn);
+        return;
+    }
+    const int slot = slotOf(note);
+    if (slot < 0)
+        return;
+    const int size = allocator.getSlotSize();
+    for (int i = 0; i < size; ++i)
+        fn(voices[slot * size + i]);
+}
+
+int Synth::slotOf(const NoteHandle& note) const {
+    if (note.slot < 0 || note.slot >= allocator.getNumSlots() || !allocator.isOccupied(note.slot)
+        || allocator.getNoteOnSeq(note.slot) != note.noteOnSeq)
+        return -1;
+    return note.slot;
+}
+
+Synth::Synth()
+    : lanes(1), workers(std::make_unique<WorkerPool>()),
+      paramBlock(std::make_unique<SynthParamBlock>()),
+      lanesSupportPatch(VoiceLanes::supports(paramBlock->params)) {
+    setPolyphony(kDefaultVoices);
+}
+
+void Synth::setRenderThreads(int numThreads) {
+    numThreads = std::max(1, numThreads);
+    if (numThreads == workers->getNumThreads())
+        return;
+    workers->start(numThreads);
+    lanes.resize(static_cast<size_t>(numThreads));
+}
+
+void Synth::setPolyphony(int numVoices) {
+    numVoices = std::clamp(numVoices, kMinVoices, kMaxVoices);
+
+    voices.assign(static_cast<size_t>(numVoices), Voice{});
+    ghosts.assign(static_cast<size_t>(kGhostVoices), Voice{});
+    forEachVoice([this](Voice& v) {
+        v.setSampleRate(sampleRate);
+        v.setControlBlockSize(controlBlockSize);
+        v.setPatchKernelsEnabled(patchKernelsEnabled);
+        v.setSilenceThreshold(silenceThresholdDb);
+        v.setParameterBlock(paramBlock.get());
+    });
+
+    allocator.reset(numVoices, slotSizeFor(voiceMode, unisonStack));
+    heldNoteCount = 0;
+
+    const size_t rendered = static_cast<size_t>(numVoices + kGhostVoices);
+    voiceBuffers.assign(rendered, {});
+    voiceBuffersRight.assign(rendered, {});
+    activeVoices.assign(rendered, nullptr);
+    activeOutputs.assign(rendered, nullptr);
+    activeOutputsRight.assign(rendered, nullptr);
+    activeGroups.assign(rendered + 1, 0);
+    jobStarts.assign(rendered + 1, 0);
+}
+
 void Synth::setSampleRate(float sr) {
     sampleRate = sr;
-    for (auto& v : voices)
-        v.setSampleRate(sr);
+    ghostFadeCoeff = Envelope::calcCoeff(kGhostFadeSeconds, sr);
+    forEachVoice([sr](Voice& v) { v.setSampleRate(sr); });
 }
 
-void Synth::setParameters(const SynthParams& params) {
-    currentParams = params;
+void Synth::setControlBlockSize(int samples) {
+    controlBlockSize = std::max(1, samples);
+    controlGridCountdown = 0;
+    forEachVoice([this](Voice& v) { v.setControlBlockSize(controlBlockSize); });
+}
+
+void Synth::setSilenceThreshold(float thresholdDb) {
+    silenceThresholdDb = thresholdDb;
+    forEachVoice([thresholdDb](Voice& v) { v.setSilenceThreshold(thresholdDb); });
+}
+
+bool Synth::isSilent() const {
+    auto active = [](const Voice& v) { return v.isActive(); };
+    return std::none_of(voices.begin(), voices.end(), active)
+        && std::none_of(ghosts.begin(), ghosts.end(), active);
+}
+
+uint64_t Synth::getCoefficientRecomputes() const {
+    uint64_t total = 0;
+    for (const auto& v : voices)
+        total += v.getCoefficientRecomputes();
+    return total;
+}
+
+float Synth::getTailLengthSeconds() const {
+    return tailLengthSeconds(paramBlock->params.env1Release, silenceThresholdDb);
+}
+
+float Synth::tailLengthSeconds(float releaseSeconds, float silenceThresholdDb) {
+    // The release multiplies the level by exp(-6.9 / (release * sr)) per
+    // sample (Envelope::calcCoeff), so reaching level L takes
+    // release * ln(1 / L) / 6.9 seconds from full scale
+    constexpr float kEnvelopeFloorDb = -80.0f;
+    float floorDb = std::max(silenceThresholdDb, kEnvelopeFloorDb);
+    float decades = -floorDb / 20.0f;
+    float seconds = std::max(0.0f, releaseSeconds) * decades * std::log(10.0f) / 6.9f;
+    return seconds + Voice::kSilenceWindowSeconds;
+}
+
+void Synth::setPatchKernelsEnabled(bool enabled) {
+    patchKernelsEnabled = enabled;
+    forEachVoice([enabled](Voice& v) { v.setPatchKernelsEnabled(enabled); });
+}
 
-    // Update voice mode state
-    voiceMode = params.voiceMode;
+void Synth::triggerVoice(int idx, int midiNote, float velocity, int leader) {
+    voices[idx].noteOn(midiNote, velocity);
+    voices[idx].alignControlBlock(controlGridCountdown);
+    voices[idx].followModulation(leader >= 0 ? &voices[leader] : nullptr, perVoiceDrift);
+}
+
+void Synth::advanceControlGrid(int numSamples) {
+    // The voices ticked somewhere in these samples
+    if (numSamples > controlGridCountdown)
+        updateStealRanks();
+    controlGridCountdown = (controlGridCountdown - numSamples) % controlBlockSize;
+    if (controlGridCountdown < 0)
+        controlGridCountdown += controlBlockSize;
+}
+
+void Synth::setParameters(const SynthParams& params) {
+    if (params == paramBlock->params)
+        return;
+    paramBlock->params = params;
+    ++paramBlock->version;
+    lanesSupportPatch = VoiceLanes::supports(params);
+
+    // Update voice mode state. A mode switch regroups the allocator's slots
+    // around the voices that are still sounding, and breaks up stacked groups:
+    // their voices may now be retriggered one at a time.
+    const int stack = params.unisonStack >= 2 ? std::min(params.unisonStack, OscillatorStack::kMaxSize) : 0;
+    if (params.voiceMode != voiceMode || stack != unisonStack) {
+        voiceMode = params.voiceMode;
+        unisonStack = stack;
+        for (auto& v : voices)
+            v.stopFollowing();
+        allocator.regroup(slotSizeFor(voiceMode, unisonStack), [this](int idx) {
+            const Voice& v = voices[idx];
+            VoiceAllocator::VoiceState state;
+            state.active = v.isActive();
+            state.held = v.isActive() && v.getAmpEnv().getStage() != Envelope::Stage::Release;
+            state.sustained = v.isSustained();
+            state.note = v.getCurrentNote();
+            return state;
+        });
+    }
     legato = params.legato;
     stereoVoiceDepth = params.stereoVoiceDepth;
     unisonVoiceDepth = params.unisonVoiceDepth;
+    perVoiceDrift = params.perVoiceDrift;
     pitchBendRange = params.pitchBendRange;
+}
 
-    // Pass per-voice parameters (drift, glide, etc.)
-    for (auto& v : voices) {
-        v.setParameters(params);
-        v.setGlideTime(params.glideTime);
+int Synth::slotSizeFor(VoiceMode mode, int stack) {
+    switch (mode) {
+        case VoiceMode::Stereo: return 2;
+        case VoiceMode::Unison: return stack > 0 ? 1 : 4;
+        default:                return 1;
     }
 }
 
-int Synth::allocateVoice() {
-    // 1. Find an idle voice
-    for (int i = 0; i < kMaxVoices; ++i) {
-        if (!voices[i].isActive())
-            return i;
+void Synth::releaseSlot(int slot) {
+    const int size = allocator.getSlotSize();
+    for (int i = 0; i < size; ++i)
+        voices[slot * size + i].noteOff();
+}
+
+void Synth::sustainSlot(int slot) {
+    const int size = allocator.getSlotSize();
+    for (int i = 0; i < size; ++i)
+        voices[slot * size + i].sustain();
+}
+
+void Synth::restrikeSlot(int slot, float velocity) {
+    const int size = allocator.getSlotSize();
+    for (int i = 0; i < size; ++i) {
+        Voice& v = voices[slot * size + i];
+        if (v.isActive())
+            v.restrike(velocity);
     }
+}
 
-    // 2. Steal the oldest active voice
-    int oldest = 0;
-    int oldestAge = std::numeric_limits<int>::max();
-    for (int i = 0; i < kMaxVoices; ++i) {
-        if (voiceAge[i] < oldestAge) {
-            oldestAge = voiceAge[i];
-            oldest = i;
-        }
+void Synth::updateStealRanks() {
+    const int size = allocator.getSlotSize();
+    allocator.forEachOccupiedSlot([this, size](int slot) {
+        float rank = 0.0f;
+        for (int i = 0; i < size; ++i)
+            rank = std::max(rank, voices[slot * size + i].getStealRank());
+        allocator.setStealRank(slot, rank);
+    });
+}
+
+void Synth::fadeOutSlot(int slot) {
+    const int size = allocator.getSlotSize();
+    for (int i = 0; i < size; ++i) {
+        Voice& v = voices[slot * size + i];
+        if (!v.isActive()) continue;
+        // An idle ghost if any, else the one closest to silence
+        Voice& ghost = *std::min_element(ghosts.begin(), ghosts.end(), [](const Voice& a, const Voice& b) {
+            return a.getStealRank() < b.getStealRank();
+        });
+        ghost.takeOver(v);
+        ghost.stopFollowing();
+        ghost.fadeOut(ghostFadeCoeff);
+        v.stop();
     }
-    return oldest;
+}
+
+void Synth::reclaimSilentSlots() {
+    const int size = allocator.getSlotSize();
+    allocator.reclaim([this, size](int slot) {
+        for (int i = 0; i < size; ++i) {
+            if (voices[slot * size + i].isActive())
+                return false;
+        }
+        return true;
+    });
 }
 
 // ============================================================================
@@ -74,41 +280,85 @@ void Synth::removeHeldNote(int note) {
 // noteOn dispatch
 // ============================================================================
 
-void Synth::noteOn(int midiNote, float velocity) {
-    switch (voiceMode) {
-        case VoiceMode::Poly:   noteOnPoly(midiNote, velocity); break;
-        case VoiceMode::Mono:   noteOnMono(midiNote, velocity); break;
-        case VoiceMode::Stereo: noteOnStereo(midiNote, velocity); break;
-        case VoiceMode::Unison: noteOnUnison(midiNote, velocity); break;
+NoteHandle Synth::noteOn(int midiNote, float velocity) {
+    if (voiceMode == VoiceMode::Mono) {
+        noteOnMono(midiNote, velocity);
+        return { midiNote };
+    }
+    int slot = allocator.restrike(midiNote);
+    if (slot >= 0) {
+        restrikeSlot(slot, velocity);
+    } else {
+        switch (voiceMode) {
+            case VoiceMode::Poly:   noteOnPoly(midiNote, velocity); break;
+            case VoiceMode::Stereo: noteOnStereo(midiNote, velocity); break;
+            case VoiceMode::Unison: noteOnUnison(midiNote, velocity); break;
+            case VoiceMode::Mono:   break;
+        }
+        slot = allocator.getNewestSlot();
     }
+    return { midiNote, slot, allocator.getNoteOnSeq(slot) };
 }
 
 void Synth::noteOff(int midiNote) {
-    switch (voiceMode) {
-        case VoiceMode::Poly:   noteOffPoly(midiNote); break;
-        case VoiceMode::Mono:   noteOffMono(midiNote); break;
-        case VoiceMode::Stereo: noteOffStereo(midiNote); break;
-        case VoiceMode::Unison: noteOffUnison(midiNote); break;
+    if (voiceMode == VoiceMode::Mono) {
+        noteOffMono(midiNote);
+        return;
+    }
+    // Poly/Stereo/Unison: release the slots holding this note, or leave
+    // them to the pedal
+    if (sustainPedal)
+        allocator.sustainNote(midiNote, [this](int slot) { sustainSlot(slot); });
+    else
+        allocator.releaseNote(midiNote, [this](int slot) { releaseSlot(slot); });
+}
+
+void Synth::noteOff(const NoteHandle& note) {
+    if (voiceMode == VoiceMode::Mono || note.slot < 0) {
+        noteOff(note.note);
+        return;
     }
+    const int slot = slotOf(note);
+    if (slot < 0)
+        return;
+    if (sustainPedal)
+        allocator.sustainSlot(slot, [this](int s) { sustainSlot(s); });
+    else
+        allocator.releaseSlot(slot, [this](int s) { releaseSlot(s); });
+}
+
+void Synth::setSustainPedal(bool down) {
+    if (down == sustainPedal)
+        return;
+    sustainPedal = down;
+    if (down)
+        return;
+    if (voiceMode == VoiceMode::Mono) {
+        if (heldNoteCount == 0 && voices[0].isSustained())
+            voices[0].noteOff();
+        return;
+    }
+    allocator.releaseSustained([this](int slot) { releaseSlot(slot); });
+}
+
+void Synth::allNotesOff() {
+    heldNoteCount = 0;
+    if (voiceMode == VoiceMode::Mono)
+        voices[0].noteOff();
+    allocator.releaseAll([this](int slot) { releaseSlot(slot); });
 }
 
 // ============================================================================
-// Poly mode: 1 voice per note, up to 8 notes
+// Poly mode: 1 voice per note, up to one note per pool voice
 // ============================================================================
 
 void Synth::noteOnPoly(int midiNote, float velocity) {
-    int idx = allocateVoice();
+    int idx = allocator.allocate(midiNote);
+    fadeOutSlot(idx);
     voices[idx].setDetuneOffset(0.0f);
     voices[idx].setPan(0.0f);
-    voices[idx].noteOn(midiNote, velocity);
-    voiceAge[idx] = ++ageCounter;
-}
-
-void Synth::noteOffPoly(int midiNote) {
-    for (int i = 0; i < kMaxVoices; ++i) {
-        if (voices[i].isActive() && voices[i].getCurrentNote() == midiNote)
-            voices[i].noteOff();
-    }
+    voices[idx].setUnisonStack(0, 0.0f);
+    triggerVoice(idx, midiNote, velocity);
 }
 
 // ============================================================================
@@ -126,9 +376,9 @@ void Synth::noteOnMono(int midiNote, float velocity) {
         // Legato: just change pitch, don't retrigger envelopes
         voices[0].noteOnLegato(midiNote);
     } else {
-        voices[0].noteOn(midiNote, velocity);
+        voices[0].setUnisonStack(0, 0.0f);
+        triggerVoice(0, midiNote, velocity);
     }
-    voiceAge[0] = ++ageCounter;
 }
 
 void Synth::noteOffMono(int midiNote) {
@@ -140,45 +390,24 @@ void Synth::noteOffMono(int midiNote) {
         if (legato) {
             voices[0].noteOnLegato(prevNote);
         } else {
-            voices[0].noteOn(prevNote, 1.0f);
+            triggerVoice(0, prevNote, 1.0f);
         }
+    } else if (sustainPedal) {
+        voices[0].sustain();
     } else {
         voices[0].noteOff();
     }
 }
 
 // ============================================================================
-// Stereo mode: 2 voices per note (L/R detuned), max 4 simultaneous notes
+// Stereo mode: 2 voices per note (L/R detuned), one note per voice pair
 // ============================================================================
 
 void Synth::noteOnStereo(int midiNote, float velocity) {
-    // Allocate pairs: voices 0+1, 2+3, 4+5, 6+7
-    // Find a free pair
-    int pairIdx = -1;
-    for (int p = 0; p < 4; ++p) {
-        int v0 = p * 2;
-        int v1 = p * 2 + 1;
-        if (!voices[v0].isActive() && !voices[v1].isActive()) {
-            pairIdx = p;
-            break;
-        }
-    }
-
-    // If no free pair, steal the oldest pair
-    if (pairIdx < 0) {
-        int oldestPair = 0;
-        int oldestPairAge = std::numeric_limits<int>::max();
-        for (int p = 0; p < 4; ++p) {
-            int v0 = p * 2;
-            int pairAge = std::min(voiceAge[v0], voiceAge[v0 + 1]);
-            if (pairAge < oldestPairAge) {
-                oldestPairAge = pairAge;
-                oldestPair = p;
-            }
-        }
-        pairIdx = oldestPair;
-    }
-
+    // Pairs: voices 0+1, 2+3, ... (a trailing odd voice is unused).
+    // A free pair if any, else the quietest pair is stolen.
+    int pairIdx = allocator.allocate(midiNote);
+    fadeOutSlot(pairIdx);
     int v0 = pairIdx * 2;
     int v1 = pairIdx * 2 + 1;
 
@@ -188,65 +417,42 @@ void Synth::noteOnStereo(int midiNote, float velocity) {
     // Left voice: detune down, pan left
     voices[v0].setDetuneOffset(-depthCents);
     voices[v0].setPan(-1.0f);
-    voices[v0].noteOn(midiNote, velocity);
-    voiceAge[v0] = ++ageCounter;
+    voices[v0].setUnisonStack(0, 0.0f);
+    triggerVoice(v0, midiNote, velocity);
 
     // Right voice: detune up, pan right
     voices[v1].setDetuneOffset(+depthCents);
     voices[v1].setPan(+1.0f);
-    voices[v1].noteOn(midiNote, velocity);
-    voiceAge[v1] = ++ageCounter;
-}
-
-void Synth::noteOffStereo(int midiNote) {
-    for (int i = 0; i < kMaxVoices; ++i) {
-        if (voices[i].isActive() && voices[i].getCurrentNote() == midiNote)
-            voices[i].noteOff();
-    }
+    voices[v1].setUnisonStack(0, 0.0f);
+    triggerVoice(v1, midiNote, velocity, v0);
 }
 
 // ============================================================================
-// Unison mode: 4 voices per note, max 2 simultaneous notes
+// Unison mode: 4 voices per note, one note per voice quad
 // ============================================================================
 
 void Synth::noteOnUnison(int midiNote, float velocity) {
-    // Allocate quads: voices 0-3, 4-7
-    int quadIdx = -1;
-    for (int q = 0; q < 2; ++q) {
-        int base = q * 4;
-        bool free = true;
-        for (int i = 0; i < 4; ++i) {
-            if (voices[base + i].isActive()) {
-                free = false;
-                break;
-            }
-        }
-        if (free) { quadIdx = q; break; }
-    }
-
-    // Steal oldest quad if none free
-    if (quadIdx < 0) {
-        int oldestQuad = 0;
-        int oldestQuadAge = std::numeric_limits<int>::max();
-        for (int q = 0; q < 2; ++q) {
-            int base = q * 4;
-            int quadAge = voiceAge[base];
-            for (int i = 1; i < 4; ++i)
-                quadAge = std::min(quadAge, voiceAge[base + i]);
-            if (quadAge < oldestQuadAge) {
-                oldestQuadAge = quadAge;
-                oldestQuad = q;
-            }
-        }
-        quadIdx = oldestQuad;
-    }
-
-    int base = quadIdx * 4;
-
     // UnisonVoiceDepth: spread in cents
     // Voices spread symmetrically: [-1.5*d, -0.5*d, +0.5*d, +1.5*d]
     // where d = unisonVoiceDepth * 20 cents
     float d = unisonVoiceDepth * 20.0f;
+
+    if (unisonStack > 0) {
+        // One voice per note; its oscillator stack spreads the same way
+        int idx = allocator.allocate(midiNote);
+        fadeOutSlot(idx);
+        voices[idx].setDetuneOffset(0.0f);
+        voices[idx].setPan(0.0f);
+        voices[idx].setUnisonStack(unisonStack, d);
+        triggerVoice(idx, midiNote, velocity);
+        return;
+    }
+
+    // Quads: voices 0-3, 4-7, ... (trailing voices are unused).
+    // A free quad if any, else the quietest quad is stolen.
+    const int quad = allocator.allocate(midiNote);
+    fadeOutSlot(quad);
+    int base = quad * 4;
     float offsets[4] = { -1.5f * d, -0.5f * d, +0.5f * d, +1.5f * d };
     // Spread panning evenly across stereo field
     float pans[4] = { -0.75f, -0.25f, +0.25f, +0.75f };
@@ -254,15 +460,8 @@ void Synth::noteOnUnison(int midiNote, float velocity) {
     for (int i = 0; i < 4; ++i) {
         voices[base + i].setDetuneOffset(offsets[i]);
         voices[base + i].setPan(pans[i]);
-        voices[base + i].noteOn(midiNote, velocity);
-        voiceAge[base + i] = ++ageCounter;
-    }
-}
-
-void Synth::noteOffUnison(int midiNote) {
-    for (int i = 0; i < kMaxVoices; ++i) {
-        if (voices[i].isActive() && voices[i].getCurrentNote() == midiNote)
-            voices[i].noteOff();
+        voices[base + i].setUnisonStack(0, 0.0f);
+        triggerVoice(base + i, midiNote, velocity, i > 0 ? base : -1);
     }
 }
 
@@ -274,9 +473,16 @@ std::pair<float, float> Synth::process() {
     float left = 0.0f;
     float right = 0.0f;
 
-    for (auto& v : voices) {
+    forEachVoice([&](Voice& v) {
+        v.syncParameters();
+        if (v.isStereo()) {
+            auto [l, r] = v.processStereo();
+            left += l;
+            right += r;
+            return;
+        }
         float mono = v.process();
-        if (mono == 0.0f) continue;
+        if (mono == 0.0f) return;
 
         float pan = v.getPan();
         // Equal-power panning: left = cos(angle), right = sin(angle)
@@ -286,18 +492,166 @@ std::pair<float, float> Synth::process() {
         float rightGain = 0.5f * (1.0f + pan);
         left += mono * leftGain;
         right += mono * rightGain;
-    }
+    });
+    advanceControlGrid(1);
+    reclaimSilentSlots();
 
     // Basic scaling factor to avoid clipping with many voices
-    left *= 0.5f;
-    right *= 0.5f;
+    left *= kOutputGain;
+    right *= kOutputGain;
 
     return {left, right};
 }
 
+// ============================================================================
+// Block rendering: same mix as process(), but voice-major over whole chunks
+// ============================================================================
+
+template <typename Sample>
+void Synth::mixVoice(const float* mono, float pan, Sample* outL, Sample* outR, int numSamples) {
+    // Same linear pan law as process(), with its output scaling folded in
+    // (a power of two, so the result is the same)
+    const Sample leftGain = kOutputGain * 0.5f * (1.0f - pan);
+    const Sample rightGain = kOutputGain * 0.5f * (1.0f + pan);
+    for (int i = 0; i < numSamples; ++i)
+        outL[i] += mono[i] * leftGain;
+    if (outR) {
+        for (int i = 0; i < numSamples; ++i)
+            outR[i] += mono[i] * rightGain;
+    }
+}
+
+template <typename Sample>
+void Synth::mixStereoVoice(const float* left, const float* right, Sample* outL, Sample* outR, int numSamples) {
+    for (int i = 0; i < numSamples; ++i)
+        outL[i] += left[i] * Sample(kOutputGain);
+    if (outR) {
+        for (int i = 0; i < numSamples; ++i)
+            outR[i] += right[i] * Sample(kOutputGain);
+    }
+}
+
+void Synth::renderActiveVoices(int numGroups, int numSamples, bool useLanes) {
+    jobSamples = numSamples;
+    jobUseLanes = useLanes;
+
+    // Scalar voices: one job per group. Lanes: fill each lane group with
+    // whole groups (at most 4 voices, so they always fit).
+    int numJobs = 0;
+    for (int g = 0; g < numGroups; ++g) {
+        if (!useLanes || numJobs == 0
+            || activeVoices[activeGroups[g]]->isStereo()
+            || activeVoices[jobStarts[numJobs - 1]]->isStereo()
+            || activeGroups[g + 1] - jobStarts[numJobs - 1] > kLaneWidth)
+            jobStarts[numJobs++] = activeGroups[g];
+    }
+    jobStarts[numJobs] = activeGroups[numGroups];
+
+    // A short chunk costs less than waking the workers: render it here
+    if (numSamples < kMinParallelSamples) {
+        for (int j = 0; j < numJobs; ++j)
+            renderJob(this, j, 0);
+        return;
+    }
+    workers->run(numJobs, &Synth::renderJob, this);
+}
+
+void Synth::renderJob(void* context, int jobIndex, int threadIndex) {
+    auto& self = *static_cast<Synth*>(context);
+    const int begin = self.jobStarts[jobIndex];
+    const int count = self.jobStarts[jobIndex + 1] - begin;
+    Voice* const* jobVoices = self.activeVoices.data() + begin;
+    float* const* jobOutputs = self.activeOutputs.data() + begin;
+
+    if (jobVoices[0]->isStereo())
+        jobVoices[0]->renderBlockStereo(jobOutputs[0], self.activeOutputsRight[begin], self.jobSamples);
+    else if (self.jobUseLanes)
+        self.lanes[threadIndex].render(jobVoices, jobOutputs, count, self.jobSamples);
+    else if (count == 1)
+        jobVoices[0]->renderBlock(jobOutputs[0], self.jobSamples);
+    else
+        Voice::renderGroup(jobVoices, jobOutputs, count, self.jobSamples);
+}
+
+void Synth::renderBlock(float* left, float* right, int numSamples) {
+    renderMix(left, right, numSamples);
+}
+
+void Synth::renderBlock(double* left, double* right, int numSamples) {
+    renderMix(left, right, numSamples);
+}
+
+template <typename Sample>
+void Synth::renderMix(Sample* left, Sample* right, int numSamples) {
+    std::fill(left, left + numSamples, Sample(0));
+    if (right) std::fill(right, right + numSamples, Sample(0));
+
+    const bool useLanes = laneEngineEnabled && lanesSupportPatch;
+
+    for (int offset = 0; offset < numSamples; offset += kRenderChunkSize) {
+        const int chunk = std::min(kRenderChunkSize, numSamples - offset);
+        Sample* outL = left + offset;
+        Sample* outR = right ? right + offset : nullptr;
+
+        // Gather active voices in voice order (ghosts last) so the mix order
+        // matches process(). A follower joins its leader's group (the leader
+        // comes first).
+        int numActive = 0;
+        int numGroups = 0;
+        forEachVoice([&](Voice& v) {
+            if (!v.isActive()) return;
+            v.syncParameters();
+            const Voice* leader = v.getModulationLeader();
+            if (leader == nullptr || numGroups == 0 || activeVoices[activeGroups[numGroups - 1]] != leader)
+                activeGroups[numGroups++] = numActive;
+            activeVoices[numActive] = &v;
+            activeOutputs[numActive] = voiceBuffers[numActive].data();
+            activeOutputsRight[numActive] = voiceBuffersRight[numActive].data();
+            ++numActive;
+        });
+        activeGroups[numGroups] = numActive;
+
+        renderActiveVoices(numGroups, chunk, useLanes);
+
+        // Mixing stays on this thread and in voice order, so the sum does not
+        // depend on how the voices were split across threads
+        for (int k = 0; k < numActive; ++k) {
+            if (activeVoices[k]->isStereo())
+                mixStereoVoice(activeOutputs[k], activeOutputsRight[k], outL, outR, chunk);
+            else
+                mixVoice(activeOutputs[k], activeVoices[k]->getPan(), outL, outR, chunk);
+        }
+        advanceControlGrid(chunk);
+        reclaimSilentSlots();
+    }
+}
+
 void Synth::setPitchBend(float semitones) {
-    for (auto& v : voices)
-        v.setPitchBend(semitones);
+    forEachVoice([semitones](Voice& v) { v.setPitchBend(semitones); });
+}
+
+void Synth::setNotePitchBend(int midiNote, float semitones) {
+    forEachNoteVoice(midiNote, [semitones](Voice& v) { v.setNotePitchBend(semitones); });
+}
+
+void Synth::setNotePressure(int midiNote, float pressure) {
+    forEachNoteVoice(midiNote, [pressure](Voice& v) { v.setNotePressure(pressure); });
+}
+
+void Synth::setNoteSlide(int midiNote, float slide) {
+    forEachNoteVoice(midiNote, [slide](Voice& v) { v.setNoteSlide(slide); });
+}
+
+void Synth::setNotePitchBend(const NoteHandle& note, float semitones) {
+    forEachHandleVoice(note, [semitones](Voice& v) { v.setNotePitchBend(semitones); });
+}
+
+void Synth::setNotePressure(const NoteHandle& note, float pressure) {
+    forEachHandleVoice(note, [pressure](Voice& v) { v.setNotePressure(pressure); });
+}
+
+void Synth::setNoteSlide(const NoteHandle& note, float slide) {
+    forEachHandleVoice(note, [slide](Voice& v) { v.setNoteSlide(slide); });
 }
 
 } // namespace vamos
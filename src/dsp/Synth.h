@@ -1,6 +1,12 @@
 #pragma once
 #include "Voice.h"
+#include "VoiceAllocator.h"
+#include "VoiceLanes.h"
+#include "WorkerPool.h"
 #include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace vamos {
 
@@ -8,8 +14,12 @@ namespace vamos {
 enum class VoiceMode { Poly, Mono, Stereo, Unison };
 
 // Polyphonic synth engine -- equivalent to Drift's VoiceModeHandler + PolyNoteAllocator<8, N>.
-// Manages 8 voices across 4 voice modes.
-static constexpr int kMaxVoices = 8;
+// Manages a pool of voices (8 by default, like Drift) across 4 voice modes.
+// Stereo mode uses the pool as pairs and Unison as quads, so the minimum is 4.
+static constexpr int kDefaultVoices = 8;
+static constexpr int kMinVoices = 4;
+static constexpr int kMaxVoices = 64;
+static_assert(kMaxVoices <= VoiceAllocator::kMaxSlots);
 
 // Parameter state passed from the JUCE processor to the DSP engine.
 struct SynthParams {
@@ -57,6 +67,10 @@ struct SynthParams {
     float monoVoiceDepth = 0.0f;
     float stereoVoiceDepth = 0.1f;  // detune between L/R voices
     float unisonVoiceDepth = 0.05f; // detune spread for unison voices
+    bool perVoiceDrift = true;      // Stereo/Unison voices drift independently
+    int unisonStack = 0;            // Unison: 2..16 = one voice per note with that
+                                    // many detuned oscillators (supersaw);
+                                    // 0 = 4 voices per note
 
     // Global parameters (Phase 7)
     float volVelMod = 0.5f;         // velocity-to-volume sensitivity (0-1)
@@ -64,22 +78,141 @@ struct SynthParams {
     bool hiQuality = false;         // oversampling (stub)
     bool resetOscPhase = false;     // reset oscillator phase on note-on
     int pitchBendRange = 2;         // pitch bend range in semitones (1-24)
+
+    bool operator==(const SynthParams&) const = default;
+};
+
+// The parameter state published by Synth::setParameters(), shared read-only
+// by every voice. version changes whenever params do, so a voice re-applies
+// the block (Voice::syncParameters) only when it has missed an update.
+struct SynthParamBlock {
+    SynthParams params;
+    uint32_t version = 1;
+
+    // Synth-wide controllers (see Synth::setModWheel), read by every voice on
+    // its control ticks. Not parameters: they change without a new version.
+    float modWheel = 0.0f;
+    float pressure = 0.0f;
+    float slide = 0.0f;
+};
+
+// One note-on, as returned by Synth::noteOn: its note, and the allocator
+// slot it took with that slot's note-on count, so the handle stops
+// addressing the slot once it is reused for another note. slot is -1 in
+// Mono mode, where a handle falls back to its note number.
+struct NoteHandle {
+    int note = -1;
+    int slot = -1;
+    uint32_t noteOnSeq = 0;
 };
 
 class Synth {
 public:
+    Synth();
+
+    // Resize the voice pool (clamped to kMinVoices..kMaxVoices) and stop all
+    // voices. Allocates -- call from prepareToPlay, never from the audio thread.
+    void setPolyphony(int numVoices);
+    int getPolyphony() const { return static_cast<int>(voices.size()); }
+
     void setSampleRate(float sr);
-    void noteOn(int midiNote, float velocity);
+    NoteHandle noteOn(int midiNote, float velocity);
     void noteOff(int midiNote);
 
-    // Apply parameter state from APVTS
+    // Note-off for one note-on only, leaving other voices on the same note
+    // sounding (MPE: one note per member channel). Nothing happens once the
+    // note's slot has been stolen.
+    void noteOff(const NoteHandle& note);
+
+    // Release every held note (MIDI All Notes Off / All Sound Off).
+    // Visits only the sounding voices, not all 128 notes.
+    void allNotesOff();
+
+    // Sustain pedal (MIDI CC64). While it is down, note-offs leave their
+    // voices sounding until it is lifted. Playing a sustained note again
+    // re-strikes its own voices instead of taking more of the pool, and a
+    // sustained voice that decays below the silence threshold is released
+    // without waiting for the pedal (see Voice::sustain).
+    void setSustainPedal(bool down);
+    bool isSustainPedalDown() const { return sustainPedal; }
+
+    // Publish parameter state from APVTS. O(1) in the pool size: an unchanged
+    // state is ignored, otherwise the shared block's version is bumped and each
+    // voice picks it up on its next note-on or render chunk.
     void setParameters(const SynthParams& params);
+    const SynthParams& getParameters() const { return paramBlock->params; }
 
-    // Render one stereo frame (left, right)
+    // Modulation sub-block size in samples for all voices (1 = per-sample, exact)
+    void setControlBlockSize(int samples);
+    int getControlBlockSize() const { return controlBlockSize; }
+    // Samples renderBlock() renders before the shared control grid ticks
+    // (0 = it ticks on the next sample)
+    int getSamplesToControlTick() const { return controlGridCountdown; }
+
+    // Render supported patches with the SIMD voice-lane engine (see VoiceLanes).
+    // Patches the lanes don't cover fall back to the scalar voices automatically.
+    void setLaneEngineEnabled(bool enabled) { laneEngineEnabled = enabled; }
+    bool isLaneEngineEnabled() const { return laneEngineEnabled; }
+
+    // Render scalar voices through per-patch compiled kernels (see
+    // Voice::setPatchKernelsEnabled). On by default; output is identical.
+    void setPatchKernelsEnabled(bool enabled);
+    bool isPatchKernelsEnabled() const { return patchKernelsEnabled; }
+
+    // Split renderBlock()'s voices across numThreads threads: the audio thread
+    // plus numThreads - 1 pre-spawned real-time workers (1 = single-threaded).
+    // Output is bit-identical for any thread count. Spawns threads -- call
+    // from prepareToPlay, never from the audio thread.
+    void setRenderThreads(int numThreads);
+    int getRenderThreads() const { return workers->getNumThreads(); }
+
+    // Releasing voices retire once their output stays below thresholdDb
+    // (dBFS peak); see Voice::setSilenceThreshold
+    void setSilenceThreshold(float thresholdDb);
+    float getSilenceThreshold() const { return silenceThresholdDb; }
+
+    // True when no voice is sounding: renderBlock() would only write zeros
+    // until the next note-on, so the caller may skip it
+    bool isSilent() const;
+
+    // Longest time a voice can keep sounding after its note-off: the amp
+    // release falling from full level to the silence threshold (or to the
+    // envelope's own -80 dB floor), plus one detection window. The filter
+    // sits before the amp envelope, so it cannot ring on after the voice.
+    float getTailLengthSeconds() const;
+    static float tailLengthSeconds(float releaseSeconds, float silenceThresholdDb);
+
+    // Instrumentation: derived coefficients recomputed by the whole pool so
+    // far (see Voice::getCoefficientRecomputes). The difference across a
+    // render divided by its length in seconds gives recomputes per second.
+    uint64_t getCoefficientRecomputes() const;
+
+    // Render one stereo frame (left, right).
+    // Per-sample reference path -- renderBlock() must match it.
     std::pair<float, float> process();
 
+    // Render numSamples stereo frames straight into the output channels,
+    // overwriting them. right may be nullptr for a mono output.
+    // Voices are rendered one at a time (Stereo/Unison groups together) over
+    // the whole block; idle voices cost nothing, so the pool size does not
+    // matter, only active voices.
+    void renderBlock(float* left, float* right, int numSamples);
+    // Same, mixed into double-precision outputs. The voices still render in
+    // single precision; their sum goes straight into the 64-bit bus without
+    // a separate conversion pass.
+    void renderBlock(double* left, double* right, int numSamples);
+
     // Access voices for visualization
-    const std::array<Voice, kMaxVoices>& getVoices() const { return voices; }
+    const std::vector<Voice>& getVoices() const { return voices; }
+
+    // Voice stealing takes the quietest slot (releasing before held, lower
+    // envelope level times velocity gain first; see Voice::getStealRank),
+    // ranked on control ticks. Its sounding voices are copied into ghost
+    // voices outside the pool, which fade out over kGhostFadeSeconds while
+    // the slot starts the new note from silence, so a steal does not click.
+    static constexpr int kGhostVoices = 4;
+    static constexpr float kGhostFadeSeconds = 0.002f;
+    const std::vector<Voice>& getGhostVoices() const { return ghosts; }
 
     // Access current voice mode for UI
     VoiceMode getVoiceMode() const { return voiceMode; }
@@ -87,37 +220,159 @@ public:
     // Pitch bend (applied to all active voices)
     void setPitchBend(float semitones);
 
+    // Per-note expression (MPE) for the voices holding midiNote (key down or
+    // sustained); see Voice::setNotePitchBend. O(1): only those voices are
+    // touched, and only to store a target.
+    void setNotePitchBend(int midiNote, float semitones);
+    void setNotePressure(int midiNote, float pressure);
+    void setNoteSlide(int midiNote, float slide);
+
+    // The same for the voices of one note-on, held or releasing, until its
+    // slot is reused: a release tail keeps following its channel's bend
+    void setNotePitchBend(const NoteHandle& note, float semitones);
+    void setNotePressure(const NoteHandle& note, float pressure);
+    void setNoteSlide(const NoteHandle& note, float slide);
+
+    // Synth-wide controllers, 0..1: mod wheel (CC1), and pressure and slide
+    // for non-MPE input (channel pressure, CC74). A voice's Pressure and
+    // Slide sources take the larger of these and its own per-note values.
+    void setModWheel(float value) { paramBlock->modWheel = value; }
+    void setPressure(float value) { paramBlock->pressure = value; }
+    void setSlide(float value) { paramBlock->slide = value; }
+
 private:
-    // Find a free voice, or steal the oldest one
-    int allocateVoice();
+    // Voices per allocator slot in each mode (Stereo pairs, Unison quads
+    // unless Unison uses an oscillator stack)
+    static int slotSizeFor(VoiceMode mode, int unisonStack);
+
+    // noteOff every voice in an allocator slot
+    void releaseSlot(int slot);
+
+    // Voice::sustain / Voice::restrike every voice in an allocator slot
+    void sustainSlot(int slot);
+    void restrikeSlot(int slot, float velocity);
+
+    // Return slots whose voices have all fallen silent to the free list
+    void reclaimSilentSlots();
+
+    // Re-rank the occupied slots for stealing (on control ticks)
+    void updateStealRanks();
+
+    // Hand a slot's sounding voices to ghosts to fade out and stop them,
+    // before the slot is retriggered (no-op for a free slot)
+    void fadeOutSlot(int slot);
+
+    // Apply fn to every voice, the pool then the ghosts
+    template <typename Fn>
+    void forEachVoice(Fn&& fn);
+
+    // Apply fn to every voice holding midiNote (see setNotePitchBend)
+    template <typename Fn>
+    void forEachNoteVoice(int midiNote, Fn&& fn);
+
+    // The slot note still addresses, or -1 once it has been reused or freed
+    int slotOf(const NoteHandle& note) const;
+
+    // Apply fn to every voice of note's slot, or of its note number in Mono
+    // mode (see setNotePitchBend(const NoteHandle&, float))
+    template <typename Fn>
+    void forEachHandleVoice(const NoteHandle& note, Fn&& fn);
+
+    // noteOn a voice and align it with the shared control grid. Stacked
+    // voices (Stereo/Unison) follow the modulation of voice leader.
+    void triggerVoice(int idx, int midiNote, float velocity, int leader = -1);
+
+    // Advance the shared control grid by numSamples
+    void advanceControlGrid(int numSamples);
+
+    // renderBlock() for either output precision
+    template <typename Sample>
+    void renderMix(Sample* left, Sample* right, int numSamples);
+
+    // Render the voices in activeVoices into activeOutputs, spread over the
+    // worker pool: one job per group in activeGroups (a voice or a stacked
+    // Stereo/Unison group), or per lane group packed from whole groups.
+    // Stereo voices always get a scalar job of their own.
+    void renderActiveVoices(int numGroups, int numSamples, bool useLanes);
+    static void renderJob(void* context, int jobIndex, int threadIndex);
+
+    // Scaling of the summed voices, to avoid clipping with many voices
+    static constexpr float kOutputGain = 0.5f;
+
+    // Add a voice's mono output to the stereo mix with its pan
+    template <typename Sample>
+    static void mixVoice(const float* mono, float pan, Sample* outL, Sample* outR, int numSamples);
+    // Add a stereo (unison stack) voice's output to the mix
+    template <typename Sample>
+    static void mixStereoVoice(const float* left, const float* right, Sample* outL, Sample* outR, int numSamples);
 
     // Per-mode note handlers
     void noteOnPoly(int midiNote, float velocity);
     void noteOnMono(int midiNote, float velocity);
     void noteOnStereo(int midiNote, float velocity);
     void noteOnUnison(int midiNote, float velocity);
-    void noteOffPoly(int midiNote);
     void noteOffMono(int midiNote);
-    void noteOffStereo(int midiNote);
-    void noteOffUnison(int midiNote);
 
-    std::array<Voice, kMaxVoices> voices;
-    // Track allocation order for voice stealing (oldest first)
-    std::array<int, kMaxVoices> voiceAge{};
-    int ageCounter = 0;
+    // Voice pool and everything sized with it (see setPolyphony)
+    std::vector<Voice> voices;
+    // Stolen voices fading out (see kGhostVoices); mixed after the pool
+    std::vector<Voice> ghosts;
+    float ghostFadeCoeff = Envelope::calcCoeff(kGhostFadeSeconds, 44100.0f);
+
+    // Per-voice mono output buffers; renderBlock() works in chunks of this
+    // size so any host block size is supported. Voices render into their own
+    // buffer and are mixed in voice order, whichever thread rendered them.
+    static constexpr int kRenderChunkSize = 128;
+    std::vector<std::array<float, kRenderChunkSize>> voiceBuffers;
+    std::vector<std::array<float, kRenderChunkSize>> voiceBuffersRight;  // stereo voices
+    std::vector<Voice*> activeVoices;
+    std::vector<float*> activeOutputs;
+    std::vector<float*> activeOutputsRight;
+    // Start of each group in activeVoices (plus an end marker); a stacked
+    // group shares modulation, so it is never split across jobs
+    std::vector<int> activeGroups;
+
+    // Voice-lane engine, one instance per render thread
+    std::vector<VoiceLanes> lanes;
+    bool laneEngineEnabled = false;
+    bool patchKernelsEnabled = true;
+
+    // Render threads, and the renderActiveVoices() call they are working on
+    std::unique_ptr<WorkerPool> workers;
+    int jobSamples = 0;
+    bool jobUseLanes = false;
+    std::vector<int> jobStarts;  // start of each job in activeVoices (plus an end marker)
+    // Chunks shorter than this skip the workers (see renderActiveVoices)
+    static constexpr int kMinParallelSamples = 32;
+
+    // Free list, steal ranks, and note -> slot index
+    VoiceAllocator allocator;
     float sampleRate = 44100.0f;
+    int controlBlockSize = 1;
+    float silenceThresholdDb = kDefaultSilenceThresholdDb;
+    // Samples until the next shared control tick. Voices started between ticks
+    // get a short first block so all voices tick together (lane engine).
+    int controlGridCountdown = 0;
 
-    SynthParams currentParams;
+    // Shared by all voices; on the heap so its address survives moving the Synth
+    std::unique_ptr<SynthParamBlock> paramBlock;
+    // VoiceLanes::supports() for the published parameters, evaluated once per
+    // setParameters() rather than every renderBlock()
+    bool lanesSupportPatch = false;
 
     // Voice mode state (Phase 6)
     VoiceMode voiceMode = VoiceMode::Poly;
     bool legato = false;
     float stereoVoiceDepth = 0.1f;
     float unisonVoiceDepth = 0.05f;
+    bool perVoiceDrift = true;
+    int unisonStack = 0;
 
     // Pitch bend state
     int pitchBendRange = 2;  // semitones
 
+    bool sustainPedal = false;
+
     // Mono mode: held note stack for legato
     static constexpr int kMaxHeldNotes = 16;
     std::array<int, kMaxHeldNotes> heldNotes{};
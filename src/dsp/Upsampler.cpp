@@ -0,0 +1,128 @@
+#include "Upsampler.h"
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace vamos {
+
+namespace {
+
+// Zeroth-order modified Bessel function of the first kind (series)
+double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+} // namespace
+
+int Upsampler::factorFor(double hostRate, double maxInternalRate) {
+    if (maxInternalRate <= 0.0)
+        return 1;
+    int f = 1;
+    // A little tolerance so 96000 / 2 counts as 48000
+    while (f < kMaxFactor && hostRate / f > maxInternalRate * 1.001)
+        f *= 2;
+    return f;
+}
+
+void Upsampler::prepare(int newFactor) {
+    factor = std::clamp(newFactor, 1, kMaxFactor);
+    coeffs.assign(static_cast<size_t>(factor * kTapsPerPhase), 0.0f);
+
+    // Windowed sinc centred on tap c = N / 2, zero crossings every factor
+    // taps. The symmetric filter would have one more tap, at 2c, but the
+    // sinc is zero there, so dropping it is exact.
+    constexpr double kBeta = 8.6;  // Kaiser window: about -90 dB sidelobes
+    const int numTaps = factor * kTapsPerPhase;
+    const double centre = 0.5 * numTaps;
+    const double norm = besselI0(kBeta);
+    for (int p = 0; p < factor; ++p) {
+        double sum = 0.0;
+        for (int j = 0; j < kTapsPerPhase; ++j) {
+            const int n = p + j * factor;
+            const double x = (n - centre) / factor;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+            const double r = (n - centre) / centre;
+            const double window = besselI0(kBeta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+            coeffs[static_cast<size_t>(p * kTapsPerPhase + j)] = static_cast<float>(sinc * window);
+            sum += sinc * window;
+        }
+        // Unity gain at DC in every phase, so a constant input stays flat
+        for (int j = 0; j < kTapsPerPhase; ++j)
+            coeffs[static_cast<size_t>(p * kTapsPerPhase + j)] /= static_cast<float>(sum);
+    }
+    reset();
+}
+
+void Upsampler::reset() {
+    for (auto& h : history) {
+        h.samples.fill(0.0f);
+        h.pos = 0;
+    }
+    carryPos = carryCount = 0;
+}
+
+int Upsampler::inputNeeded(int numOutput) const {
+    const int fromInput = numOutput - (carryCount - carryPos);
+    return fromInput > 0 ? (fromInput + factor - 1) / factor : 0;
+}
+
+void Upsampler::interpolate(int channel, float input, float* out) {
+    History& h = history[static_cast<size_t>(channel)];
+    h.pos = (h.pos == 0 ? kTapsPerPhase : h.pos) - 1;
+    h.samples[static_cast<size_t>(h.pos)] = input;
+    h.samples[static_cast<size_t>(h.pos + kTapsPerPhase)] = input;
+
+    const float* window = h.samples.data() + h.pos;
+    for (int p = 0; p < factor; ++p) {
+        const float* c = coeffs.data() + p * kTapsPerPhase;
+        float acc = 0.0f;
+        for (int j = 0; j < kTapsPerPhase; ++j)
+            acc += c[j] * window[j];
+        out[p] = acc;
+    }
+}
+
+void Upsampler::process(const float* inLeft, const float* inRight, int numInput,
+                        float* outLeft, float* outRight, int numOutput) {
+    processInto(inLeft, inRight, numInput, outLeft, outRight, numOutput);
+}
+
+void Upsampler::process(const float* inLeft, const float* inRight, int numInput,
+                        double* outLeft, double* outRight, int numOutput) {
+    processInto(inLeft, inRight, numInput, outLeft, outRight, numOutput);
+}
+
+template <typename Sample>
+void Upsampler::processInto(const float* inLeft, const float* inRight, int numInput,
+                            Sample* outLeft, Sample* outRight, int numOutput) {
+    if (factor == 1) {
+        std::copy(inLeft, inLeft + numOutput, outLeft);
+        if (outRight) std::copy(inRight, inRight + numOutput, outRight);
+        return;
+    }
+
+    int written = 0;
+    auto drainCarry = [&] {
+        const int n = std::min(carryCount - carryPos, numOutput - written);
+        std::copy_n(carry[0].data() + carryPos, n, outLeft + written);
+        if (outRight) std::copy_n(carry[1].data() + carryPos, n, outRight + written);
+        carryPos += n;
+        written += n;
+    };
+
+    drainCarry();
+    for (int i = 0; i < numInput; ++i) {
+        interpolate(0, inLeft[i], carry[0].data());
+        if (outRight) interpolate(1, inRight[i], carry[1].data());
+        carryPos = 0;
+        carryCount = factor;
+        drainCarry();
+    }
+}
+
+} // namespace vamos
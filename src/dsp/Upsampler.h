@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <vector>
+
+namespace vamos {
+
+// Stereo polyphase interpolator by an integer factor, for rendering the
+// voice engine at a lower internal rate than the host's.
+//
+// A Kaiser-windowed sinc (kTapsPerPhase taps per output phase, about
+// -90 dB stopband) cut off at the internal Nyquist frequency removes the
+// images above it. Each input sample yields factor output samples, so the
+// engine renders inputNeeded(n) samples for n host samples; output left over
+// from the last input sample is carried into the next call.
+//
+// The filter delays the signal by getLatencySamples() output samples.
+class Upsampler {
+public:
+    static constexpr int kTapsPerPhase = 32;
+    static constexpr int kMaxFactor = 8;
+
+    // Smallest power-of-two factor (up to kMaxFactor) that brings hostRate
+    // down to maxInternalRate or below; 1 if maxInternalRate <= 0 (off)
+    static int factorFor(double hostRate, double maxInternalRate);
+
+    // Design the filter for factor (1 = pass-through) and clear the state.
+    // Allocates -- call from prepareToPlay, never from the audio thread.
+    void prepare(int factor);
+    int getFactor() const { return factor; }
+
+    // Delay of the filter in output (host) samples
+    int getLatencySamples() const { return factor > 1 ? kTapsPerPhase / 2 * factor : 0; }
+
+    // Clear the filter history and the carried output
+    void reset();
+
+    // Input samples process() needs to produce numOutput more output samples
+    int inputNeeded(int numOutput) const;
+
+    // Consume numInput = inputNeeded(numOutput) input samples and write
+    // numOutput output samples. The right channel pointers may both be
+    // nullptr for a mono output.
+    void process(const float* inLeft, const float* inRight, int numInput,
+                 float* outLeft, float* outRight, int numOutput);
+    // Same, into double-precision outputs (the filter runs in single precision)
+    void process(const float* inLeft, const float* inRight, int numInput,
+                 double* outLeft, double* outRight, int numOutput);
+
+private:
+    template <typename Sample>
+    void processInto(const float* inLeft, const float* inRight, int numInput,
+                     Sample* outLeft, Sample* outRight, int numOutput);
+
+    // Push one input sample through every phase into out[0..factor)
+    void interpolate(int channel, float input, float* out);
+
+    int factor = 1;
+
+    // coeffs[p * kTapsPerPhase + j] = h[p + j * factor]: phase p's taps,
+    // newest input first
+    std::vector<float> coeffs;
+
+    // Per channel: the last kTapsPerPhase inputs, newest first, stored twice
+    // so a window never wraps
+    struct History {
+        std::array<float, 2 * kTapsPerPhase> samples{};
+        int pos = 0;
+    };
+    std::array<History, 2> history{};
+
+    // Outputs of the last input sample not yet written
+    std::array<std::array<float, kMaxFactor>, 2> carry{};
+    int carryPos = 0;
+    int carryCount = 0;
+};
+
+} // namespace vamos
@@ -1,47 +1,111 @@
 #include "Voice.h"
 #include "Synth.h" // for SynthParams
+#include "FastMath.h"
 #include <cmath>
 #include <algorithm>
+#include <array>
+#include <utility>
 
 namespace vamos {
 
-float Voice::midiToFreq(int note) {
-    // Standard equal temperament: A4 (MIDI 69) = 440 Hz
+namespace {
+
+// Standard equal temperament: A4 (MIDI 69) = 440 Hz
+float equalTemperedFreq(int note) {
     return 440.0f * std::pow(2.0f, (static_cast<float>(note) - 69.0f) / 12.0f);
 }
 
+// Every note midiToFreq() sees in practice -- MIDI notes shifted by the osc2
+// transpose range -- precomputed, so note-on needs no pow()
+constexpr int kFirstTabledNote = -64;
+constexpr int kNumTabledNotes = 256;
+const std::array<float, kNumTabledNotes> kNoteFrequencies = [] {
+    std::array<float, kNumTabledNotes> table{};
+    for (int i = 0; i < kNumTabledNotes; ++i)
+        table[i] = equalTemperedFreq(kFirstTabledNote + i);
+    return table;
+}();
+
+// Equal temperament on a fractional pitch in semitones
+float pitchToFreq(float semitones) {
+    return 440.0f * math::exp2((semitones - 69.0f) / 12.0f);
+}
+
+} // namespace
+
+float Voice::midiToFreq(int note) {
+    const int index = note - kFirstTabledNote;
+    if (index >= 0 && index < kNumTabledNotes)
+        return kNoteFrequencies[index];
+    return equalTemperedFreq(note);
+}
+
 void Voice::setSampleRate(float sr) {
     sampleRate = sr;
     osc1.setSampleRate(sr);
     osc2.setSampleRate(sr);
     noise.setSampleRate(sr);
     filter.setSampleRate(sr);
+    ctl->filterRight.setSampleRate(sr);
+    ctl->stack.setSampleRate(sr);
     ampEnv.setSampleRate(sr);
-    modEnv.setSampleRate(sr);
-    cycEnv.setSampleRate(sr);
-    lfo.setSampleRate(sr);
-    drift.setSampleRate(sr);
 
-    // Recalculate glide rate if glide is active
-    if (glideTime > 0.0f)
-        glideRate = 1.0f - std::exp(-1.0f / (glideTime * sampleRate));
+    // Modulators tick once per control block
+    ctl->modEnv.setSampleRate(controlRate());
+    ctl->cycEnv.setSampleRate(controlRate());
+    ctl->lfo.setSampleRate(controlRate());
+    ctl->drift.setSampleRate(controlRate());
+
+    // Glide rate and expression smoothing depend on the control rate
+    updateGlideRate();
+    ctl->expressionSmoothing = 1.0f - std::exp(-1.0f / (kExpressionSmoothingSeconds * controlRate()));
+
+    setSilenceThreshold(ctl->silenceThresholdDb);
+}
+
+void Voice::setSilenceThreshold(float thresholdDb) {
+    ctl->silenceThresholdDb = thresholdDb;
+    silenceThreshold = thresholdDb > -200.0f ? std::pow(10.0f, thresholdDb / 20.0f) : 0.0f;
+    silenceWindow = std::max(1, static_cast<int>(kSilenceWindowSeconds * sampleRate));
+}
+
+void Voice::setControlBlockSize(int samples) {
+    controlBlockSize = std::max(1, samples);
+    controlCountdown = 0;
+    setSampleRate(sampleRate);
 }
 
 void Voice::setGlideTime(float seconds) {
-    glideTime = seconds;
-    if (glideTime > 0.0f && sampleRate > 0.0f)
-        glideRate = 1.0f - std::exp(-1.0f / (glideTime * sampleRate));
-    else
-        glideRate = 1.0f; // instant
+    if (seconds == ctl->glideTime)
+        return;
+    ctl->glideTime = seconds;
+    updateGlideRate();
+}
+
+void Voice::updateGlideRate() {
+    if (ctl->glideTime > 0.0f && sampleRate > 0.0f) {
+        ctl->glideRate = 1.0f - std::exp(-1.0f / (ctl->glideTime * controlRate()));
+        ++ctl->recomputes;
+    } else {
+        ctl->glideRate = 1.0f; // instant
+    }
+}
+
+uint64_t Voice::getCoefficientRecomputes() const {
+    return uint64_t{ctl->recomputes}
+         + ampEnv.getCoefficientRecomputes() + ctl->modEnv.getCoefficientRecomputes()
+         + filter.getCoefficientRecomputes() + ctl->filterRight.getCoefficientRecomputes()
+         + ctl->lfo.getCoefficientRecomputes();
 }
 
 void Voice::setParameters(const SynthParams& p) {
     // Oscillator types and shape
     osc1.setType(p.osc1Type);
     osc1.setShape(p.osc1Shape);
+    ctl->stack.setType(p.osc1Type);
     osc2.setType(p.osc2Type);
-    osc2Detune = p.osc2Detune;
-    osc2Transpose = p.osc2Transpose;
+    ctl->osc2Detune = p.osc2Detune;
+    ctl->osc2Transpose = p.osc2Transpose;
 
     // Mixer
     mixer.setOsc1Gain(p.osc1Gain);
@@ -56,254 +120,627 @@ void Voice::setParameters(const SynthParams& p) {
     ampEnv.setParams({p.env1Attack, p.env1Decay, p.env1Sustain, p.env1Release});
 
     // Filter
-    paramFilterType = p.filterType;
-    paramFilterFreq = p.filterFreq;
-    paramFilterRes = p.filterRes;
-    paramFilterTracking = p.filterTracking;
+    ctl->paramFilterType = p.filterType;
+    ctl->paramFilterFreq = p.filterFreq;
+    ctl->paramFilterRes = p.filterRes;
+    ctl->paramFilterTracking = p.filterTracking;
 
     // LFO
-    lfo.setShape(p.lfoShape);
-    lfo.setRate(p.lfoRate);
-    lfo.setAmount(p.lfoAmount);
+    ctl->lfo.setShape(p.lfoShape);
+    ctl->paramLfoRate = p.lfoRate;
+    ctl->lfo.setRate(p.lfoRate);
+    ctl->lfo.setAmount(p.lfoAmount);
 
     // Drift
-    driftDepth = p.driftDepth;
+    ctl->driftDepth = p.driftDepth;
 
     // Global (Phase 7)
-    volVelMod = p.volVelMod;
-    globalTranspose = p.transpose;
-    resetOscPhase = p.resetOscPhase;
-    pitchBendRange = p.pitchBendRange;
+    ctl->volVelMod = p.volVelMod;
+    ctl->globalTranspose = p.transpose;
+    ctl->resetOscPhase = p.resetOscPhase;
+    ctl->pitchBendRange = p.pitchBendRange;
+}
+
+void Voice::setParameterBlock(const SynthParamBlock* block) {
+    ctl->paramBlock = block;
+    ctl->paramVersion = 0;
+    syncParameters();
+}
+
+void Voice::syncParameters() {
+    const SynthParamBlock* block = ctl->paramBlock;
+    if (block == nullptr || block->version == ctl->paramVersion)
+        return;
+    ctl->paramVersion = block->version;
+    setParameters(block->params);
+    setGlideTime(block->params.glideTime);
+}
+
+void Voice::setUnisonStack(int size, float spreadCents) {
+    int previous = ctl->stack.getSize();
+    ctl->stack.configure(size, spreadCents);
+    if (ctl->stack.getSize() != previous)
+        ctl->stack.resetPhases();
 }
 
 void Voice::noteOn(int midiNote, float velocity) {
+    syncParameters();
+
     // If glide is active and voice was already playing, start from current pitch
     bool wasActive = isActive();
-    float prevFreq = currentFreq;
+    float prevPitch = ctl->currentPitch;
 
     currentNote = midiNote;
-    currentVelocity = velocity;
-    targetFreq = midiToFreq(midiNote);
-
-    if (wasActive && glideTime > 0.0f) {
-        // Glide from previous pitch
-        currentFreq = prevFreq;
+    ctl->currentVelocity = velocity;
+    ctl->sustained = false;
+    ctl->expression = {};
+    ctl->snapExpression = true;
+    ctl->targetPitch = static_cast<float>(midiNote);
+
+    if (wasActive && ctl->glideTime > 0.0f) {
+        // Glide from previous pitch; the oscillators keep their frequencies
+        ctl->currentPitch = prevPitch;
     } else {
         // Jump to new pitch immediately
-        currentFreq = targetFreq;
+        ctl->currentPitch = ctl->targetPitch;
+        osc1.setFrequency(midiToFreq(midiNote));
+        osc2.setFrequency(midiToFreq(midiNote + ctl->osc2Transpose));
     }
-
-    // Set initial frequencies (will be updated per-sample in process())
-    osc1.setFrequency(currentFreq);
-
-    float osc2Freq = midiToFreq(midiNote + osc2Transpose);
-    if (osc2Detune != 0.0f)
-        osc2Freq *= std::pow(2.0f, osc2Detune / 1200.0f);
-    osc2.setFrequency(osc2Freq);
+    // The first control tick sets the modulated frequencies (applyModulation)
 
     // Optionally reset oscillator phase on note-on
-    if (resetOscPhase) {
+    if (ctl->resetOscPhase) {
         osc1.resetPhase();
         osc2.resetPhase();
+        ctl->stack.resetPhases();
     }
 
     // Reset filter state for new note
     filter.reset();
+    ctl->filterRight.reset();
 
     // Trigger amp envelope
     ampEnv.noteOn();
 
-    // Mod envelope (Env2): Drift default A=0.001, D=0.6, S=0.2, R=0.6
-    modEnv.setParams({0.001f, 0.6f, 0.2f, 0.6f});
-    modEnv.noteOn();
+    // Mod envelope (Env2), fixed at the Drift defaults (see ControlState)
+    ctl->modEnv.noteOn();
 
     // Cycling envelope
-    cycEnv.reset();
+    ctl->cycEnv.reset();
 
     // LFO: handle retrigger
-    lfo.noteOn();
+    ctl->lfo.noteOn();
+
+    // Start a fresh control block aligned with the note, without ramping
+    // from the previous note's modulation values
+    controlCountdown = 0;
+    firstControlBlock = 0;
+    snapControls = true;
+    releasePeak = 0.0f;
+    releaseSamples = 0;
 }
 
 void Voice::noteOnLegato(int midiNote) {
+    syncParameters();
+
     // Legato: change pitch without retriggering envelopes
     currentNote = midiNote;
-    targetFreq = midiToFreq(midiNote);
+    ctl->targetPitch = static_cast<float>(midiNote);
 
     // If no glide, jump immediately
-    if (glideTime <= 0.0f)
-        currentFreq = targetFreq;
+    if (ctl->glideTime <= 0.0f)
+        ctl->currentPitch = ctl->targetPitch;
     // Otherwise glide will happen in process()
 }
 
+void Voice::restrike(float velocity) {
+    syncParameters();
+    ctl->currentVelocity = velocity;
+    ctl->sustained = false;
+    ampEnv.noteOn();
+    ctl->modEnv.noteOn();
+    ctl->lfo.noteOn();
+    releasePeak = 0.0f;
+    releaseSamples = 0;
+}
+
+void Voice::takeOver(Voice& other) {
+    // Hold all four delay lines aside, so the copy moves only empty vectors
+    std::vector<float> mine, mineRight, theirs, theirsRight;
+    filter.swapDelayLine(mine);
+    ctl->filterRight.swapDelayLine(mineRight);
+    other.filter.swapDelayLine(theirs);
+    other.ctl->filterRight.swapDelayLine(theirsRight);
+
+    *this = other;  // ctl reuses this voice's storage: no allocation
+
+    filter.swapDelayLine(theirs);
+    ctl->filterRight.swapDelayLine(theirsRight);
+    other.filter.swapDelayLine(mine);
+    other.ctl->filterRight.swapDelayLine(mineRight);
+}
+
 void Voice::noteOff() {
     ampEnv.noteOff();
-    modEnv.noteOff();
+    ctl->modEnv.noteOff();
+    ctl->sustained = false;
+}
+
+void Voice::renderBlock(float* out, int numSamples) {
+    int i = 0;
+    while (i < numSamples && isActive()) {
+        if (controlCountdown == 0) {
+            tickControl();
+            if (!isActive()) break;  // retired as silent
+        }
+        const int n = std::min(controlCountdown, numSamples - i);
+        renderAudio(out + i, n);
+        controlCountdown -= n;
+        i += n;
+    }
+    // Voice finished (or was idle): the rest of the block is silence
+    std::fill(out + i, out + numSamples, 0.0f);
+}
+
+void Voice::renderGroup(Voice* const* voices, float* const* outputs, int numVoices, int numSamples) {
+    int i = 0;
+    while (i < numSamples) {
+        // Tick due voices in order (leader first); the segment ends at the
+        // earliest next tick so no voice runs past a shared update
+        int segment = numSamples - i;
+        bool anyActive = false;
+        for (int k = 0; k < numVoices; ++k) {
+            Voice& v = *voices[k];
+            if (!v.isActive()) continue;
+            if (v.controlCountdown == 0) {
+                v.tickControl();
+                if (!v.isActive()) continue;  // retired as silent
+            }
+            anyActive = true;
+            segment = std::min(segment, v.controlCountdown);
+        }
+        if (!anyActive) break;
+
+        for (int k = 0; k < numVoices; ++k) {
+            Voice& v = *voices[k];
+            if (v.isActive()) {
+                v.renderAudio(outputs[k] + i, segment);
+                v.controlCountdown -= segment;
+            } else {
+                std::fill(outputs[k] + i, outputs[k] + i + segment, 0.0f);
+            }
+        }
+        i += segment;
+    }
+    for (int k = 0; k < numVoices; ++k)
+        std::fill(outputs[k] + i, outputs[k] + numSamples, 0.0f);
+}
+
+void Voice::renderBlockStereo(float* left, float* right, int numSamples) {
+    if (!isStereo()) {
+        renderBlock(left, numSamples);
+        std::copy(left, left + numSamples, right);
+        return;
+    }
+    int i = 0;
+    while (i < numSamples && isActive()) {
+        if (controlCountdown == 0) {
+            tickControl();
+            if (!isActive()) break;  // retired as silent
+        }
+        const int n = std::min(controlCountdown, numSamples - i);
+        renderAudioStack(left + i, right + i, n);
+        controlCountdown -= n;
+        i += n;
+    }
+    std::fill(left + i, left + numSamples, 0.0f);
+    std::fill(right + i, right + numSamples, 0.0f);
 }
 
 float Voice::process() {
-    if (!isActive()) return 0.0f;
+    if (isStereo()) {
+        auto [left, right] = processStereo();
+        return left + right;
+    }
+    float out = 0.0f;
+    renderBlock(&out, 1);
+    return out;
+}
+
+std::pair<float, float> Voice::processStereo() {
+    float left = 0.0f, right = 0.0f;
+    renderBlockStereo(&left, &right, 1);
+    return { left, right };
+}
+
+void Voice::tickControl() {
+    // Retire a release that stayed below the silence threshold for a window
+    if (releaseSamples >= silenceWindow) {
+        bool silent = releasePeak < silenceThreshold;
+        releasePeak = 0.0f;
+        releaseSamples = 0;
+        if (silent) {
+            ampEnv.reset();
+            return;
+        }
+    }
+
+    updateControl();
+    controlCountdown = firstControlBlock > 0 ? firstControlBlock : controlBlockSize;
+    firstControlBlock = 0;
+
+    // A sustained note that has decayed out of hearing need not wait for the pedal
+    if (ctl->sustained && ampEnv.getStage() != Envelope::Stage::Attack
+        && ampEnv.getLevel() * velGain < silenceThreshold)
+        noteOff();
+
+    const Envelope::Stage stage = ampEnv.getStage();
+    const float level = stage == Envelope::Stage::Attack ? 1.0f : ampEnv.getLevel();
+    const bool keyDown = stage != Envelope::Stage::Release && !ctl->sustained;
+    ctl->stealRank = (keyDown ? 1.0f : 0.0f) + level * velGain;
+}
+
+void Voice::trackSilence(const float* left, const float* right, int numSamples) {
+    if (silenceThreshold <= 0.0f || ampEnv.getStage() != Envelope::Stage::Release)
+        return;
+    float peak = releasePeak;
+    for (int i = 0; i < numSamples; ++i)
+        peak = std::max(peak, std::abs(left[i]));
+    if (right) {
+        for (int i = 0; i < numSamples; ++i)
+            peak = std::max(peak, std::abs(right[i]));
+    }
+    releasePeak = peak;
+    releaseSamples += numSamples;
+}
+
+void Voice::followModulation(const Voice* leader, bool keepOwnDrift) {
+    modLeader = leader;
+    ctl->ownDrift = keepOwnDrift;
+}
+
+void Voice::stopFollowing() {
+    if (modLeader == nullptr)
+        return;
+    ctl->modEnv = modLeader->ctl->modEnv;
+    ctl->cycEnv = modLeader->ctl->cycEnv;
+    ctl->lfo = modLeader->ctl->lfo;
+    if (!ctl->ownDrift)
+        ctl->drift = modLeader->ctl->drift;
+    ctl->targetPitch = modLeader->ctl->targetPitch;
+    ctl->currentPitch = modLeader->ctl->currentPitch;
+    modLeader = nullptr;
+}
 
+void Voice::updateControl() {
+    // Snap on the first tick of a note; otherwise ramp over the control block
+    const int rampLength = snapControls ? 1 : controlBlockSize;
+    snapControls = false;
+
+    // A silent leader no longer ticks
+    if (modLeader != nullptr && !modLeader->isActive())
+        stopFollowing();
+
+    if (modLeader != nullptr) {
+        // Stacked voice: the leader has already ticked for this block
+        ctl->shared = modLeader->ctl->shared;
+        ctl->modCtx = modLeader->ctl->modCtx;
+        ctl->currentPitch = modLeader->ctl->currentPitch;
+        if (ctl->ownDrift)
+            ctl->shared.driftCents = ctl->drift.process(ctl->driftDepth);
+    } else {
+        updateModulation();
+    }
+    applyModulation(rampLength);
+}
+
+void Voice::updateModulation() {
     // ================================================================
-    // 0. Glide: smoothly move currentFreq toward targetFreq
+    // 0. Glide: smoothly move currentPitch toward targetPitch. In
+    //    semitones, so every octave of the glide takes the same time
     // ================================================================
-    if (glideTime > 0.0f && currentFreq != targetFreq) {
-        currentFreq += (targetFreq - currentFreq) * glideRate;
-        // Snap when very close
-        if (std::abs(currentFreq - targetFreq) < 0.01f)
-            currentFreq = targetFreq;
+    if (ctl->glideTime > 0.0f && ctl->currentPitch != ctl->targetPitch) {
+        ctl->currentPitch += (ctl->targetPitch - ctl->currentPitch) * ctl->glideRate;
+        // Snap within a tenth of a cent
+        if (std::abs(ctl->currentPitch - ctl->targetPitch) < 0.001f)
+            ctl->currentPitch = ctl->targetPitch;
     }
 
     // ================================================================
     // 0b. Analog drift: slow random pitch wander (in cents)
     // ================================================================
-    float driftCents = drift.process(driftDepth);
+    ctl->shared.driftCents = ctl->drift.process(ctl->driftDepth);
 
     // ================================================================
     // 1. Tick all modulators and build ModContext
     // ================================================================
     float env1Val = ampEnv.getLevel();
-    float modEnvVal = modEnv.process();
-    float cycEnvVal = cycEnv.process();
-    float lfoVal = lfo.process();
-
-    modCtx.env1 = env1Val;
-    modCtx.env2Cyc = (env2Mode == Envelope2Mode::Env) ? modEnvVal : cycEnvVal;
-    modCtx.lfo = lfoVal;
-    modCtx.velocity = currentVelocity;
-    modCtx.modwheel = 0.0f;
-    modCtx.pressure = 0.0f;
-    modCtx.slide = 0.0f;
-    modCtx.key = (static_cast<float>(currentNote) - 60.0f) / 60.0f;
+    float modEnvVal = ctl->modEnv.process();
+    float cycEnvVal = ctl->cycEnv.process();
+    float lfoVal = ctl->lfo.process();
+
+    ctl->modCtx.env1 = env1Val;
+    ctl->modCtx.env2Cyc = (ctl->env2Mode == Envelope2Mode::Env) ? modEnvVal : cycEnvVal;
+    ctl->modCtx.lfo = lfoVal;
+    ctl->modCtx.velocity = ctl->currentVelocity;
+
+    // Expression: the per-note values glide to their targets here, once per
+    // tick, however densely the controller stream updated them
+    NoteExpression& expr = ctl->smoothedExpression;
+    if (ctl->snapExpression) {
+        expr = ctl->expression;
+        ctl->snapExpression = false;
+    } else {
+        const float k = ctl->expressionSmoothing;
+        expr.bend += (ctl->expression.bend - expr.bend) * k;
+        expr.pressure += (ctl->expression.pressure - expr.pressure) * k;
+        expr.slide += (ctl->expression.slide - expr.slide) * k;
+    }
+    const SynthParamBlock* block = ctl->paramBlock;
+    ctl->modCtx.modwheel = block ? block->modWheel : 0.0f;
+    ctl->modCtx.pressure = std::max(expr.pressure, block ? block->pressure : 0.0f);
+    ctl->modCtx.slide = std::max(expr.slide, block ? block->slide : 0.0f);
+    ctl->shared.noteBendSemitones = expr.bend;
+    ctl->modCtx.key = (static_cast<float>(currentNote) - 60.0f) / 60.0f;
 
     // ================================================================
-    // 2. Apply pitch modulation
+    // 2. Pitch modulation
     // ================================================================
     constexpr float kPitchRange = 48.0f;
-    float pitchModSemitones =
-        modCtx.get(modMatrix.pitchModSource1) * modMatrix.pitchModAmount1 * kPitchRange
-      + modCtx.get(modMatrix.pitchModSource2) * modMatrix.pitchModAmount2 * kPitchRange;
+    ctl->shared.pitchModSemitones =
+        ctl->modCtx.get(ctl->modMatrix.pitchModSource1) * ctl->modMatrix.pitchModAmount1 * kPitchRange
+      + ctl->modCtx.get(ctl->modMatrix.pitchModSource2) * ctl->modMatrix.pitchModAmount2 * kPitchRange;
 
     // Osc2 detune modulation from general matrix
-    float osc2DetuneMod = modMatrix.resolveTarget(ModTarget::Osc2Detune, modCtx);
     constexpr float kDetuneRange = 100.0f;
-
-    // Use currentFreq (with glide) instead of raw MIDI note freq
-    // Apply drift + detune offset (from voice mode) in cents
-    // Also apply global transpose and pitch bend
-    float totalCentsOffset = driftCents + detuneOffset;
-    float totalSemitonesOffset = pitchModSemitones + pitchBendValue;
-    float baseFreq1 = currentFreq
-        * std::pow(2.0f, totalCentsOffset / 1200.0f)
-        * std::pow(2.0f, static_cast<float>(globalTranspose) / 12.0f);
-    float modulatedFreq1 = baseFreq1 * std::pow(2.0f, totalSemitonesOffset / 12.0f);
-    osc1.setFrequency(std::clamp(modulatedFreq1, 8.0f, 20000.0f));
-
-    float baseFreq2 = midiToFreq(currentNote + osc2Transpose + globalTranspose);
-    if (osc2Detune != 0.0f)
-        baseFreq2 *= std::pow(2.0f, osc2Detune / 1200.0f);
-    // Apply drift to osc2 as well
-    baseFreq2 *= std::pow(2.0f, (driftCents + detuneOffset) / 1200.0f);
-    float totalDetuneCents = osc2DetuneMod * kDetuneRange;
-    float modulatedFreq2 = baseFreq2
-        * std::pow(2.0f, pitchModSemitones / 12.0f)
-        * std::pow(2.0f, totalDetuneCents / 1200.0f);
-    osc2.setFrequency(std::clamp(modulatedFreq2, 8.0f, 20000.0f));
+    ctl->shared.osc2DetuneCents = ctl->modMatrix.resolveTarget(ModTarget::Osc2Detune, ctl->modCtx) * kDetuneRange;
 
     // ================================================================
-    // 3. Apply shape modulation to Osc1
+    // 3. Shape modulation for Osc1
     // ================================================================
-    float shapeMod = modCtx.get(modMatrix.shapeModSource) * modMatrix.shapeModAmount;
-    shapeMod += modMatrix.resolveTarget(ModTarget::Osc1Shape, modCtx);
-    osc1.setShape(std::clamp(shapeMod, -1.0f, 1.0f));
+    float shapeMod = ctl->modCtx.get(ctl->modMatrix.shapeModSource) * ctl->modMatrix.shapeModAmount;
+    shapeMod += ctl->modMatrix.resolveTarget(ModTarget::Osc1Shape, ctl->modCtx);
+    ctl->shared.osc1Shape = std::clamp(shapeMod, -1.0f, 1.0f);
 
     // ================================================================
-    // 4. Apply mixer gain modulation
+    // 4. Mixer gain modulation
     // ================================================================
-    float osc1GainMod = modMatrix.resolveTarget(ModTarget::Osc1Gain, modCtx);
-    float osc2GainMod = modMatrix.resolveTarget(ModTarget::Osc2Gain, modCtx);
-    float noiseGainMod = modMatrix.resolveTarget(ModTarget::NoiseGain, modCtx);
+    float osc1GainMod = ctl->modMatrix.resolveTarget(ModTarget::Osc1Gain, ctl->modCtx);
+    float osc2GainMod = ctl->modMatrix.resolveTarget(ModTarget::Osc2Gain, ctl->modCtx);
+    float noiseGainMod = ctl->modMatrix.resolveTarget(ModTarget::NoiseGain, ctl->modCtx);
 
-    float modOsc1Gain = std::clamp(mixer.getOsc1Gain() + osc1GainMod, 0.0f, 2.0f);
-    float modOsc2Gain = std::clamp(mixer.getOsc2Gain() + osc2GainMod, 0.0f, 2.0f);
-    float modNoiseGain = std::clamp(mixer.getNoiseLevel() + noiseGainMod, 0.0f, 2.0f);
+    ctl->shared.osc1Gain = std::clamp(mixer.getOsc1Gain() + osc1GainMod, 0.0f, 2.0f);
+    ctl->shared.osc2Gain = std::clamp(mixer.getOsc2Gain() + osc2GainMod, 0.0f, 2.0f);
+    ctl->shared.noiseGain = std::clamp(mixer.getNoiseLevel() + noiseGainMod, 0.0f, 2.0f);
 
     // ================================================================
     // 5. Apply LFO rate and CycEnv rate modulation
     // ================================================================
-    float lfoRateMod = modMatrix.resolveTarget(ModTarget::LFORate, modCtx);
-    if (lfoRateMod != 0.0f) {
-        float modRate = lfo.getRate() * std::pow(2.0f, lfoRateMod);
-        lfo.setRate(std::clamp(modRate, 0.01f, 100.0f));
-    }
-
-    float cycRateMod = modMatrix.resolveTarget(ModTarget::CycEnvRate, modCtx);
+    // From the parameter's rate, so the modulation does not compound tick
+    // after tick (parameters are no longer re-applied every block)
+    float lfoRateMod = ctl->modMatrix.resolveTarget(ModTarget::LFORate, ctl->modCtx);
+    float lfoRate = ctl->paramLfoRate;
+    if (lfoRateMod != 0.0f)
+        lfoRate = std::clamp(lfoRate * math::exp2(lfoRateMod), 0.01f, 100.0f);
+    ctl->lfo.setRate(lfoRate);
+
+    float cycRateMod = ctl->modMatrix.resolveTarget(ModTarget::CycEnvRate, ctl->modCtx);
     if (cycRateMod != 0.0f) {
-        float modRate = cycEnv.getRate() * std::pow(2.0f, cycRateMod);
-        cycEnv.setRate(std::clamp(modRate, 0.01f, 100.0f));
+        float modRate = ctl->cycEnv.getRate() * math::exp2(cycRateMod);
+        ctl->cycEnv.setRate(std::clamp(modRate, 0.01f, 100.0f));
     }
 
     // ================================================================
-    // 6. Apply filter modulation
+    // 6. Filter modulation
     // ================================================================
     constexpr float kFilterRange = 120.0f;
 
     float filterModSemitones =
-        modCtx.get(modMatrix.filterModSource1) * modMatrix.filterModAmount1 * kFilterRange
-      + modCtx.get(modMatrix.filterModSource2) * modMatrix.filterModAmount2 * kFilterRange;
-    filterModSemitones += modMatrix.resolveTarget(ModTarget::LPFrequency, modCtx) * kFilterRange;
-
-    FilterParams fp;
-    fp.type = paramFilterType;
-    fp.frequency = paramFilterFreq;
-    fp.resonance = paramFilterRes;
-    fp.hiPassFrequency = 10.0f;
-    fp.tracking = paramFilterTracking;
-    fp.oscThrough1 = true;
-    fp.oscThrough2 = true;
-    fp.noiseThrough = true;
-
-    float modulatedCutoff = fp.frequency * std::pow(2.0f, filterModSemitones / 12.0f);
-    modulatedCutoff = std::clamp(modulatedCutoff, 20.0f, 20000.0f);
-    fp.frequency = modulatedCutoff;
+        ctl->modCtx.get(ctl->modMatrix.filterModSource1) * ctl->modMatrix.filterModAmount1 * kFilterRange
+      + ctl->modCtx.get(ctl->modMatrix.filterModSource2) * ctl->modMatrix.filterModAmount2 * kFilterRange;
+    filterModSemitones += ctl->modMatrix.resolveTarget(ModTarget::LPFrequency, ctl->modCtx) * kFilterRange;
 
-    float hpMod = modMatrix.resolveTarget(ModTarget::HPFrequency, modCtx) * kFilterRange;
-    float modulatedHP = fp.hiPassFrequency * std::pow(2.0f, hpMod / 12.0f);
-    fp.hiPassFrequency = std::clamp(modulatedHP, 10.0f, 20000.0f);
+    float modulatedCutoff = ctl->paramFilterFreq * math::exp2(filterModSemitones / 12.0f);
+    ctl->shared.cutoff = std::clamp(modulatedCutoff, 20.0f, 20000.0f);
 
-    float resMod = modMatrix.resolveTarget(ModTarget::LPResonance, modCtx);
-    fp.resonance = std::clamp(fp.resonance + resMod, 0.0f, 1.0f);
+    constexpr float kHiPassBase = 10.0f;
+    float hpMod = ctl->modMatrix.resolveTarget(ModTarget::HPFrequency, ctl->modCtx) * kFilterRange;
+    float modulatedHP = kHiPassBase * math::exp2(hpMod / 12.0f);
+    ctl->shared.hiPass = std::clamp(modulatedHP, 10.0f, 20000.0f);
 
-    filter.setParams(fp);
+    float resMod = ctl->modMatrix.resolveTarget(ModTarget::LPResonance, ctl->modCtx);
+    ctl->shared.resonance = std::clamp(ctl->paramFilterRes + resMod, 0.0f, 1.0f);
 
     // ================================================================
-    // 7. Generate audio through the signal chain
+    // 7. MainVolume modulation (multiplicative)
     // ================================================================
-    float osc1Out = osc1.process();
-    float osc2Out = osc2.process();
-    float noiseOut = noise.process();
-
-    float osc1Mixed = mixer.isOsc1On() ? modOsc1Gain * osc1Out : 0.0f;
-    float osc2Mixed = mixer.isOsc2On() ? modOsc2Gain * osc2Out : 0.0f;
-    float noiseMixed = mixer.isNoiseOn() ? modNoiseGain * noiseOut : 0.0f;
-
-    float filterOut = filter.process(osc1Mixed, osc2Mixed, noiseMixed, currentNote);
+    float volMod = ctl->modMatrix.resolveTarget(ModTarget::MainVolume, ctl->modCtx);
+    ctl->shared.volume = volMod != 0.0f ? std::clamp(1.0f + volMod, 0.0f, 2.0f) : 1.0f;
+}
 
-    float envOut = ampEnv.process();
+void Voice::applyModulation(int rampLength) {
+    // Pitch is summed in semitones -- the gliding note, global transpose,
+    // drift and voice-mode detune, pitch modulation, global and per-note
+    // bend -- and converted to Hz once per oscillator. Osc2 follows the
+    // same pitch, plus its transpose and detune.
+    const float pitch1 = ctl->currentPitch
+        + static_cast<float>(ctl->globalTranspose)
+        + (ctl->shared.driftCents + ctl->detuneOffset) / 100.0f
+        + ctl->shared.pitchModSemitones
+        + ctl->pitchBendValue + ctl->shared.noteBendSemitones;
+    const float pitch2 = pitch1
+        + static_cast<float>(ctl->osc2Transpose)
+        + (ctl->osc2Detune + ctl->shared.osc2DetuneCents) / 100.0f;
+    osc1FreqRamp.rampTo(std::clamp(pitchToFreq(pitch1), 8.0f, 20000.0f), rampLength);
+    osc2FreqRamp.rampTo(std::clamp(pitchToFreq(pitch2), 8.0f, 20000.0f), rampLength);
+
+    osc1ShapeRamp.rampTo(ctl->shared.osc1Shape, rampLength);
+    osc1GainRamp.rampTo(ctl->shared.osc1Gain, rampLength);
+    osc2GainRamp.rampTo(ctl->shared.osc2Gain, rampLength);
+    noiseGainRamp.rampTo(ctl->shared.noiseGain, rampLength);
+
+    filterParams.type = ctl->paramFilterType;
+    filterParams.tracking = ctl->paramFilterTracking;
+    filterParams.oscThrough1 = true;
+    filterParams.oscThrough2 = true;
+    filterParams.noiseThrough = true;
+    cutoffRamp.rampTo(ctl->shared.cutoff, rampLength);
+    hiPassRamp.rampTo(ctl->shared.hiPass, rampLength);
+    resonanceRamp.rampTo(ctl->shared.resonance, rampLength);
+
+    // volVelMod controls how much velocity affects volume
+    velGain = 1.0f - ctl->volVelMod * (1.0f - ctl->currentVelocity);
+    volumeRamp.rampTo(ctl->shared.volume, rampLength);
+}
 
-    // Velocity scaling: volVelMod controls how much velocity affects volume
-    float velGain = 1.0f - volVelMod * (1.0f - currentVelocity);
+void Voice::renderAudio(float* out, int numSamples) {
+    // One table lookup per segment instead of three switches per sample
+    AudioKernel kernel = patchKernels
+        ? findAudioKernel(osc1.getType(), osc2.getType(), filterParams.type)
+        : &Voice::renderAudioKernel<false, OscillatorType1::Saw, OscillatorType1::Saw, FilterType::I>;
+    (this->*kernel)(out, numSamples);
+    trackSilence(out, nullptr, numSamples);
+}
 
-    float output = filterOut * envOut * velGain;
+Voice::AudioKernel Voice::findAudioKernel(OscillatorType1 osc1Type, OscillatorType1 osc2Type, FilterType type) {
+    // Every combination, generated at compile time (7 x 7 x 8 kernels)
+    constexpr int kOscTypes = static_cast<int>(OscillatorType1::Saturated) + 1;
+    constexpr int kFilterTypes = static_cast<int>(FilterType::Resampling) + 1;
+    static constexpr auto kernels = []<std::size_t... I>(std::index_sequence<I...>) {
+        return std::array<AudioKernel, sizeof...(I)> {
+            &Voice::renderAudioKernel<true,
+                                      static_cast<OscillatorType1>(I / (kOscTypes * kFilterTypes)),
+                                      static_cast<OscillatorType1>(I / kFilterTypes % kOscTypes),
+                                      static_cast<FilterType>(I % kFilterTypes)>...
+        };
+    }(std::make_index_sequence<kOscTypes * kOscTypes * kFilterTypes>());
+
+    int index = (static_cast<int>(osc1Type) * kOscTypes + static_cast<int>(osc2Type)) * kFilterTypes
+              + static_cast<int>(type);
+    return kernels[static_cast<std::size_t>(index)];
+}
 
-    // ================================================================
-    // 8. Apply MainVolume modulation (multiplicative)
-    // ================================================================
-    float volMod = modMatrix.resolveTarget(ModTarget::MainVolume, modCtx);
-    if (volMod != 0.0f) {
-        output *= std::clamp(1.0f + volMod, 0.0f, 2.0f);
+template <bool Fixed, OscillatorType1 Osc1, OscillatorType1 Osc2, FilterType Type>
+void Voice::renderAudioKernel(float* out, int numSamples) {
+    auto osc1Sample = [this] {
+        if constexpr (Fixed) return osc1.processAs<Osc1>();
+        else return osc1.process();
+    };
+    auto osc2Sample = [this] {
+        if constexpr (Fixed) return osc2.processAs<Osc2>();
+        else return osc2.process();
+    };
+    auto filterSample = [this](float in1, float in2, float inNoise) {
+        if constexpr (Fixed) return filter.processAs<Type>(in1, in2, inNoise, currentNote);
+        else return filter.process(in1, in2, inNoise, currentNote);
+    };
+
+    // A source that is switched off or muted for the whole segment is not
+    // rendered. Muted oscillators still advance so they keep their phase;
+    // noise has none, so it stops entirely.
+    const bool osc1Live = mixer.isOsc1On() && !osc1GainRamp.isZero();
+    const bool osc2Live = mixer.isOsc2On() && !osc2GainRamp.isZero();
+    const bool noiseLive = mixer.isNoiseOn() && !noiseGainRamp.isZero();
+
+    for (int i = 0; i < numSamples; ++i) {
+        // ================================================================
+        // Advance control ramps
+        // ================================================================
+        osc1.setFrequency(osc1FreqRamp.next());
+        osc2.setFrequency(osc2FreqRamp.next());
+        osc1.setShape(osc1ShapeRamp.next());
+        float modOsc1Gain = osc1GainRamp.next();
+        float modOsc2Gain = osc2GainRamp.next();
+        float modNoiseGain = noiseGainRamp.next();
+
+        filterParams.frequency = cutoffRamp.next();
+        filterParams.hiPassFrequency = hiPassRamp.next();
+        filterParams.resonance = resonanceRamp.next();
+        filter.setParams(filterParams);
+
+        float volume = volumeRamp.next();
+
+        // ================================================================
+        // Generate audio through the signal chain
+        // ================================================================
+        float osc1Mixed = 0.0f;
+        if (osc1Live)
+            osc1Mixed = modOsc1Gain * osc1Sample();
+        else
+            osc1.advance();
+
+        float osc2Mixed = 0.0f;
+        if (osc2Live)
+            osc2Mixed = modOsc2Gain * osc2Sample();
+        else
+            osc2.advance();
+
+        float noiseMixed = noiseLive ? modNoiseGain * noise.process() : 0.0f;
+
+        float filterOut = filterSample(osc1Mixed, osc2Mixed, noiseMixed);
+
+        float envOut = ampEnv.process();
+
+        out[i] = filterOut * envOut * velGain * volume;
     }
+}
 
-    return output;
+void Voice::renderAudioStack(float* left, float* right, int numSamples) {
+    // Dead sources are skipped as in renderAudio()
+    const bool osc1Live = mixer.isOsc1On() && !osc1GainRamp.isZero();
+    const bool osc2Live = mixer.isOsc2On() && !osc2GainRamp.isZero();
+    const bool noiseLive = mixer.isNoiseOn() && !noiseGainRamp.isZero();
+
+    // The stack renders a chunk at a time from the osc1 pitch and shape ramps;
+    // everything after it runs per sample as in renderAudio(), once per channel
+    constexpr int kChunk = 32;
+    float freq[kChunk], shape[kChunk], stackL[kChunk], stackR[kChunk];
+
+    for (int start = 0; start < numSamples; start += kChunk) {
+        const int n = std::min(kChunk, numSamples - start);
+        for (int i = 0; i < n; ++i) {
+            freq[i] = osc1FreqRamp.next();
+            shape[i] = osc1ShapeRamp.next();
+        }
+        if (osc1Live)
+            ctl->stack.render(freq, shape, stackL, stackR, n);
+        else
+            ctl->stack.advance(freq, n);
+
+        for (int i = 0; i < n; ++i) {
+            osc2.setFrequency(osc2FreqRamp.next());
+            float modOsc1Gain = osc1GainRamp.next();
+            float modOsc2Gain = osc2GainRamp.next();
+            float modNoiseGain = noiseGainRamp.next();
+
+            filterParams.frequency = cutoffRamp.next();
+            filterParams.hiPassFrequency = hiPassRamp.next();
+            filterParams.resonance = resonanceRamp.next();
+            filter.setParams(filterParams);
+            ctl->filterRight.setParams(filterParams);
+
+            float volume = volumeRamp.next();
+
+            // Osc2 and noise sit in the centre, like a voice with pan 0
+            float osc2Mixed = 0.0f;
+            if (osc2Live)
+                osc2Mixed = modOsc2Gain * osc2.process();
+            else
+                osc2.advance();
+            float noiseMixed = noiseLive ? modNoiseGain * noise.process() : 0.0f;
+            float osc1L = osc1Live ? modOsc1Gain * stackL[i] : 0.0f;
+            float osc1R = osc1Live ? modOsc1Gain * stackR[i] : 0.0f;
+
+            float outL = filter.process(osc1L, osc2Mixed, noiseMixed, currentNote);
+            float outR = ctl->filterRight.process(osc1R, osc2Mixed, noiseMixed, currentNote);
+
+            // Synth's linear pan law: a centred voice reaches each side at 0.5
+            float gain = 0.5f * ampEnv.process() * velGain * volume;
+            left[start + i] = outL * gain;
+            right[start + i] = outR * gain;
+        }
+    }
+    trackSilence(left, right, numSamples);
 }
 
 } // namespace vamos
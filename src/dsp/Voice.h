@@ -8,15 +8,30 @@
 #include "CyclingEnvelope.h"
 #include "Modulation.h"
 #include "Drift.h"
+#include "ControlRamp.h"
+#include "OscillatorStack.h"
+#include "Boxed.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 
 namespace vamos {
 
-// Forward declaration
+// Forward declarations
 struct SynthParams;
+struct SynthParamBlock;
+
+// Releasing voices whose output stays below this level are retired (dBFS peak)
+static constexpr float kDefaultSilenceThresholdDb = -90.0f;
 
 // A single synth voice — equivalent to Ableton's DriftVoiceBlock.
 // Signal flow: Osc1 + Osc2 + Noise -> Mixer gains -> Filter (with Through routing) -> Amp (Env1)
-// Modulators: Env2, CyclingEnvelope, LFO — computed per-sample, stored in ModContext.
+// Modulators: Env2, CyclingEnvelope, LFO — computed once per control block, stored in ModContext.
+//
+// Control rate: modulators, glide, drift and the pitch/filter/gain targets are
+// evaluated once every controlBlockSize samples and linearly ramped in between.
+// Only the oscillators, noise, filter and amp envelope run at audio rate.
+// A control block size of 1 evaluates everything per sample (exact behavior).
 class Voice {
 public:
     void setSampleRate(float sr);
@@ -24,32 +39,136 @@ public:
     void noteOnLegato(int midiNote);  // Change pitch without retriggering envelopes
     void noteOff();
     bool isActive() const { return ampEnv.isActive(); }
+
+    // Sustain pedal: sustain() is a key-up while the pedal is down. The voice
+    // keeps sounding until noteOff(), but releases itself once its level
+    // falls below the silence threshold (see setSilenceThreshold).
+    // restrike() plays the note again on the same voice: the envelopes
+    // re-attack from their current level, pitch, oscillators and filter
+    // carry on, so there is no click.
+    void sustain() { ctl->sustained = true; }
+    bool isSustained() const { return ctl->sustained; }
+    void restrike(float velocity);
     int getCurrentNote() const { return currentNote; }
 
-    // Apply parameter state from APVTS (called each block)
+    // Voice stealing (see Synth): fadeOut() releases with the envelope
+    // coefficient coeff instead of the release time; stop() silences at once.
+    void fadeOut(float coeff) { ampEnv.fastRelease(coeff); }
+    void stop() { ampEnv.reset(); }
+
+    // Become a copy of other, except that the filter delay lines trade
+    // places with other's instead of being copied, so a steal costs the same
+    // at any sample rate. other keeps this voice's old delay lines: stop or
+    // retrigger it before it renders again.
+    void takeOver(Voice& other);
+
+    // How much stealing this voice would be heard: its amp envelope level
+    // times velocity gain (full level during the attack), plus 1 while the
+    // key is down -- not released or sustained. As of the last control tick,
+    // so every render path agrees. 0 when idle.
+    float getStealRank() const { return isActive() ? ctl->stealRank : 0.0f; }
+
+    // Apply parameter state from APVTS
     void setParameters(const SynthParams& params);
 
-    // Render one sample (mono -- stereo pair is at the Synth level)
+    // Follow a parameter block shared by the whole pool (set by Synth).
+    // syncParameters() applies it -- parameters and glide time -- only if its
+    // version changed since the last sync; noteOn() syncs first.
+    // nullptr = parameters come from setParameters() only.
+    void setParameterBlock(const SynthParamBlock* block);
+    void syncParameters();
+
+    // Derived coefficients (envelope, filter prewarp and tracking, glide,
+    // LFO smoothing) computed since construction. Each is recomputed only
+    // when one of its inputs changes, so a held, unmodulated note costs none.
+    uint64_t getCoefficientRecomputes() const;
+
+    // Render one sample (mono -- stereo pair is at the Synth level).
+    // A voice with a unison stack (isStereo()) returns the sum of its channels.
     float process();
 
+    // Render a block of samples (mono), overwriting out[0..numSamples).
+    // Equivalent to calling process() numSamples times.
+    void renderBlock(float* out, int numSamples);
+
+    // Unison oscillator stack: replace osc 1 with size detuned copies spaced
+    // spreadCents apart and panned across the stereo field (see
+    // OscillatorStack); 0 = single oscillator. Set before noteOn().
+    void setUnisonStack(int size, float spreadCents);
+    int getUnisonStackSize() const { return ctl->stack.getSize(); }
+
+    // A voice with a unison stack renders its own stereo image: use
+    // processStereo() / renderBlockStereo() and mix the result without panning.
+    // A mono voice writes the same signal to both channels.
+    bool isStereo() const { return ctl->stack.getSize() > 0; }
+    std::pair<float, float> processStereo();
+    void renderBlockStereo(float* left, float* right, int numSamples);
+
+    // renderBlock() for a stacked group (leader first, then its followers),
+    // one control block at a time so the leader always ticks first
+    static void renderGroup(Voice* const* voices, float* const* outputs, int numVoices, int numSamples);
+
+    // Stereo/Unison stacking: take the control-rate modulation (modulators,
+    // glide, mod matrix) from leader instead of running this voice's own, so
+    // only detune and pan differ. The leader must tick first on every control
+    // tick (lower voice index; see renderGroup). keepOwnDrift keeps this
+    // voice's own drift instead of the leader's. nullptr = run independently.
+    void followModulation(const Voice* leader, bool keepOwnDrift);
+    const Voice* getModulationLeader() const { return modLeader; }
+
+    // Stop following: carry on from the leader's modulator state
+    void stopFollowing();
+
+    // Render through the audio loop compiled for the current patch (osc1 and
+    // osc2 waveforms, filter type) instead of switching on them per sample.
+    // Output is identical; off is the reference path for benchmarks.
+    void setPatchKernelsEnabled(bool enabled) { patchKernels = enabled; }
+
+    // Retire the voice during its release once its output peak stays below
+    // thresholdDb (dBFS) for a whole detection window (kSilenceWindowSeconds),
+    // instead of waiting for the envelope to reach its own -80 dB floor.
+    // Checked on control ticks, so every render path retires at the same
+    // sample. A threshold at or below -200 dB turns detection off.
+    void setSilenceThreshold(float thresholdDb);
+    static constexpr float kSilenceWindowSeconds = 0.02f;
+
+    // Control-rate sub-block size in samples (1 = per-sample modulation)
+    void setControlBlockSize(int samples);
+    int getControlBlockSize() const { return controlBlockSize; }
+
+    // Shorten the first control block after a note-on so the voice re-joins
+    // the synth's shared control grid (samples until the next grid tick)
+    void alignControlBlock(int samplesUntilTick) { firstControlBlock = samplesUntilTick; }
+
     // Glide control
     void setGlideTime(float seconds);
-    float getGlideTime() const { return glideTime; }
+    float getGlideTime() const { return ctl->glideTime; }
 
     // Drift control
-    void setDriftDepth(float depth) { driftDepth = depth; }
-    float getDriftDepth() const { return driftDepth; }
+    void setDriftDepth(float depth) { ctl->driftDepth = depth; }
+    float getDriftDepth() const { return ctl->driftDepth; }
 
     // Per-voice detune offset in cents (used for stereo/unison modes)
-    void setDetuneOffset(float cents) { detuneOffset = cents; }
-    float getDetuneOffset() const { return detuneOffset; }
+    void setDetuneOffset(float cents) { ctl->detuneOffset = cents; }
+    float getDetuneOffset() const { return ctl->detuneOffset; }
 
     // Per-voice pan (-1 = full left, +1 = full right, 0 = center)
     void setPan(float p) { pan = p; }
     float getPan() const { return pan; }
 
     // Pitch bend (in semitones, applied to all oscillators)
-    void setPitchBend(float semitones) { pitchBendValue = semitones; }
+    void setPitchBend(float semitones) { ctl->pitchBendValue = semitones; }
+
+    // Per-note expression (MPE): pitch bend in semitones on top of
+    // setPitchBend(), pressure and slide 0..1 (the Pressure and Slide mod
+    // sources, together with the synth-wide values in SynthParamBlock).
+    // Setting one only stores its target: the voice glides to it on its
+    // control ticks (kExpressionSmoothingSeconds). noteOn() resets them to
+    // 0, and the first tick of a note jumps to the targets set since.
+    void setNotePitchBend(float semitones) { ctl->expression.bend = semitones; }
+    void setNotePressure(float pressure) { ctl->expression.pressure = pressure; }
+    void setNoteSlide(float slide) { ctl->expression.slide = slide; }
+    static constexpr float kExpressionSmoothingSeconds = 0.005f;
 
     // Access components for visualization
     const Oscillator& getOsc1() const { return osc1; }
@@ -58,18 +177,62 @@ public:
     const Mixer& getMixer() const { return mixer; }
     const Filter& getFilter() const { return filter; }
     const Envelope& getAmpEnv() const { return ampEnv; }
-    const LFO& getLfo() const { return lfo; }
-    const CyclingEnvelope& getCycEnv() const { return cycEnv; }
-    const Envelope& getModEnv() const { return modEnv; }
-    const ModContext& getModContext() const { return modCtx; }
-    const ModMatrix& getModMatrix() const { return modMatrix; }
+    const LFO& getLfo() const { return ctl->lfo; }
+    const CyclingEnvelope& getCycEnv() const { return ctl->cycEnv; }
+    const Envelope& getModEnv() const { return ctl->modEnv; }
+    const ModContext& getModContext() const { return ctl->modCtx; }
+    const ModMatrix& getModMatrix() const { return ctl->modMatrix; }
+
+    void setEnvelope2Mode(Envelope2Mode mode) { ctl->env2Mode = mode; }
+    Envelope2Mode getEnvelope2Mode() const { return ctl->env2Mode; }
 
-    void setEnvelope2Mode(Envelope2Mode mode) { env2Mode = mode; }
-    Envelope2Mode getEnvelope2Mode() const { return env2Mode; }
+    // Upper bound on sizeof(Voice): the state the audio-rate loop touches,
+    // eight cache lines. Everything else lives in ControlState on the heap.
+    static constexpr std::size_t kHotBytesBudget = 512;
 
 private:
+    friend class VoiceLanes;
+
     static float midiToFreq(int note);
 
+    // Run updateControl() and start the next control block
+    void tickControl();
+
+    // Tick modulators and compute new ramp targets (once per control block)
+    void updateControl();
+
+    // Tick modulators and resolve the mod matrix into shared
+    void updateModulation();
+
+    // Ramp to the targets in shared, adding this voice's detune and drift
+    void applyModulation(int rampLength);
+
+    // Render numSamples of audio using the current control ramps, through
+    // the patch kernel chosen for this segment
+    void renderAudio(float* out, int numSamples);
+
+    // The audio loop for one patch. Fixed compiles the waveforms and the
+    // filter type in; otherwise they are switched on per sample.
+    template <bool Fixed, OscillatorType1 Osc1, OscillatorType1 Osc2, FilterType Type>
+    void renderAudioKernel(float* out, int numSamples);
+    using AudioKernel = void (Voice::*)(float* out, int numSamples);
+    static AudioKernel findAudioKernel(OscillatorType1 osc1Type, OscillatorType1 osc2Type, FilterType type);
+    void renderAudioStack(float* left, float* right, int numSamples);
+
+    // Add rendered output to the silence detector (releasing voices only)
+    void trackSilence(const float* left, const float* right, int numSamples);
+
+    // Recompute glideRate from glideTime and the control rate
+    void updateGlideRate();
+
+    // Sample rate seen by the control-rate modulators
+    float controlRate() const { return sampleRate / static_cast<float>(controlBlockSize); }
+
+    // ========================================================================
+    // Hot state: everything the audio-rate loop touches, kept in Voice itself
+    // so a std::vector<Voice> packs it contiguously (see kHotBytesBudget)
+    // ========================================================================
+
     // === Active DSP blocks ===
     Oscillator osc1;
     Oscillator osc2;       // Osc2: uses Oscillator class, limited to Type2 waveforms
@@ -78,51 +241,141 @@ private:
     Filter filter;
     Envelope ampEnv;
 
-    // === Modulators (Phase 4) ===
-    Envelope modEnv;            // Envelope 2 (ADSR mode)
-    CyclingEnvelope cycEnv;     // Envelope 2 (Cycling mode)
-    LFO lfo;
-    Envelope2Mode env2Mode = Envelope2Mode::Env;
-    ModContext modCtx;
+    // === Control ramps, advanced per sample ===
+    ControlRamp osc1FreqRamp;
+    ControlRamp osc2FreqRamp;
+    ControlRamp osc1ShapeRamp;
+    ControlRamp osc1GainRamp;
+    ControlRamp osc2GainRamp;
+    ControlRamp noiseGainRamp;
+    ControlRamp cutoffRamp;
+    ControlRamp hiPassRamp;
+    ControlRamp resonanceRamp;
+    ControlRamp volumeRamp;
+    FilterParams filterParams;  // type/tracking/routing, refreshed per control tick
+    float velGain = 1.0f;       // velocity scaling, updated per control tick
 
-    // === Modulation routing (Phase 5) ===
-    ModMatrix modMatrix;        // Drift defaults set in constructor
+    // === Control rate ===
+    int controlBlockSize = 1;   // samples per control tick
+    int controlCountdown = 0;   // samples left until the next control tick
+    int firstControlBlock = 0;  // length of the block after a note-on (0 = full block)
+    bool patchKernels = true;   // see setPatchKernelsEnabled
+    bool snapControls = true;   // next tick jumps instead of ramping (after noteOn)
 
-    // === Analog Drift (Phase 6) ===
-    AnalogDrift drift;
-    float driftDepth = 0.072f;  // Drift preset default
+    // === Silence detection (see setSilenceThreshold) ===
+    float silenceThreshold = 0.0f;  // linear peak, 0 = off
+    int silenceWindow = 1;          // samples per detection window
+    float releasePeak = 0.0f;       // output peak in the current window
+    int releaseSamples = 0;         // samples rendered in the current window
 
-    // === Glide / Portamento (Phase 6) ===
-    float targetFreq = 440.0f;
-    float currentFreq = 440.0f;
-    float glideTime = 0.0f;     // seconds (0 = instant)
-    float glideRate = 1.0f;     // calculated from glideTime and sampleRate
-
-    // === Voice mode support (Phase 6) ===
-    float detuneOffset = 0.0f;  // cents, for stereo/unison detuning
+    // === Mixing (read by Synth every render chunk) ===
     float pan = 0.0f;           // -1..+1, for stereo mode panning
-
-    // === Osc2 parameters ===
-    float osc2Detune = 0.0f;     // cents
-    int osc2Transpose = -12;     // semitones (Drift default: -1 octave)
-
-    // === APVTS-driven filter parameters ===
-    FilterType paramFilterType = FilterType::I;
-    float paramFilterFreq = 20000.0f;
-    float paramFilterRes = 0.0f;
-    float paramFilterTracking = 0.0f;
-
-    // === Global parameters (Phase 7) ===
-    float volVelMod = 0.5f;
-    int globalTranspose = 0;
-    bool resetOscPhase = false;
-    int pitchBendRange = 2;
-    float pitchBendValue = 0.0f;    // current pitch bend in semitones
+    const Voice* modLeader = nullptr;
 
     // === State ===
     int currentNote = -1;
-    float currentVelocity = 0.0f;
     float sampleRate = 44100.0f;
+
+    // ========================================================================
+    // Cold state: control-rate modulation, patch parameters and the unison
+    // stack. Touched once per control block (the stack only in its own
+    // mode), so it lives in one heap block per voice.
+    // ========================================================================
+
+    // Per-note expression values (see setNotePitchBend)
+    struct NoteExpression {
+        float bend = 0.0f;
+        float pressure = 0.0f;
+        float slide = 0.0f;
+    };
+
+    // Modulation resolved on the last control tick, everything but detune
+    // and drift -- what a stacked group shares
+    struct SharedModulation {
+        float driftCents = 0.0f;
+        float pitchModSemitones = 0.0f;
+        float noteBendSemitones = 0.0f;
+        float osc2DetuneCents = 0.0f;
+        float osc1Shape = 0.0f;
+        float osc1Gain = 0.0f;
+        float osc2Gain = 0.0f;
+        float noiseGain = 0.0f;
+        float cutoff = 20000.0f;
+        float hiPass = 10.0f;
+        float resonance = 0.0f;
+        float volume = 1.0f;
+    };
+
+    struct ControlState {
+        // Env2's ADSR is not a parameter: Drift's A=0.001, D=0.6, S=0.2, R=0.6
+        ControlState() { modEnv.setParams({0.001f, 0.6f, 0.2f, 0.6f}); }
+
+        // === Unison oscillator stack (replaces osc1 when enabled) ===
+        OscillatorStack stack;
+        Filter filterRight;     // right channel of a stacked voice (filter is left)
+
+        // === Modulators (Phase 4) ===
+        Envelope modEnv;            // Envelope 2 (ADSR mode)
+        CyclingEnvelope cycEnv;     // Envelope 2 (Cycling mode)
+        LFO lfo;
+        Envelope2Mode env2Mode = Envelope2Mode::Env;
+        ModContext modCtx;
+
+        // === Modulation routing (Phase 5) ===
+        ModMatrix modMatrix;        // Drift defaults set in constructor
+
+        // === Analog Drift (Phase 6) ===
+        AnalogDrift drift;
+        float driftDepth = 0.072f;  // Drift preset default
+
+        // === Glide / Portamento (Phase 6), in semitones (MIDI note numbers) ===
+        float targetPitch = 69.0f;
+        float currentPitch = 69.0f;
+        float glideTime = 0.0f;     // seconds (0 = instant)
+        float glideRate = 1.0f;     // calculated from glideTime and the control rate
+
+        // === Per-note expression: targets, and their smoothed values ===
+        NoteExpression expression;
+        NoteExpression smoothedExpression;
+        float expressionSmoothing = 1.0f;   // one-pole coefficient per control tick
+        bool snapExpression = true;         // next tick jumps (after noteOn)
+
+        // === Shared parameters (see setParameterBlock) ===
+        const SynthParamBlock* paramBlock = nullptr;
+        uint32_t paramVersion = 0;  // version of paramBlock last applied
+
+        // === Voice mode support (Phase 6) ===
+        float detuneOffset = 0.0f;  // cents, for stereo/unison detuning
+        SharedModulation shared;
+        bool ownDrift = true;
+
+        // === Osc2 parameters ===
+        float osc2Detune = 0.0f;     // cents
+        int osc2Transpose = -12;     // semitones (Drift default: -1 octave)
+
+        // === APVTS-driven filter parameters ===
+        FilterType paramFilterType = FilterType::I;
+        float paramFilterFreq = 20000.0f;
+        float paramFilterRes = 0.0f;
+        float paramFilterTracking = 0.0f;
+
+        // === LFO rate before LFORate modulation ===
+        float paramLfoRate = 0.4f;
+
+        // === Global parameters (Phase 7) ===
+        float volVelMod = 0.5f;
+        int globalTranspose = 0;
+        bool resetOscPhase = false;
+        int pitchBendRange = 2;
+        float pitchBendValue = 0.0f;    // current pitch bend in semitones
+
+        float silenceThresholdDb = kDefaultSilenceThresholdDb;
+        float currentVelocity = 0.0f;
+        float stealRank = 0.0f;     // see getStealRank
+        bool sustained = false;     // see sustain
+        uint32_t recomputes = 0;    // glide rate (see getCoefficientRecomputes)
+    };
+    Boxed<ControlState> ctl;
 };
 
 } // namespace vamos
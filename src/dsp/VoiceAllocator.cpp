@@ -0,0 +1,180 @@
+#include "VoiceAllocator.h"
+#include <algorithm>
+
+namespace vamos {
+
+void VoiceAllocator::reset(int voices, int size) {
+    numVoices = std::clamp(voices, 0, kMaxSlots);
+    slotSize = std::max(1, size);
+    numSlots = numVoices / slotSize;
+
+    slots.fill(Slot{});
+    noteHead.fill(-1);
+    oldest = newest = -1;
+    heapSize = 0;
+
+    // Free list in index order, so a fresh allocator hands out slot 0 first
+    freeHead = -1;
+    for (int slot = numSlots - 1; slot >= 0; --slot)
+        pushFree(slot);
+}
+
+int VoiceAllocator::allocate(int midiNote) {
+    int slot = freeHead;
+    if (slot >= 0) {
+        freeHead = slots[slot].next;
+    } else {
+        // Steal the lowest ranked occupied slot
+        slot = heap[0];
+        unlinkOccupied(slot);
+        if (slots[slot].held)
+            unhold(slot);
+    }
+
+    linkNewest(slot);
+    if (midiNote >= 0 && midiNote < kNumNotes)
+        hold(slot, midiNote);
+    return slot;
+}
+
+int VoiceAllocator::restrike(int midiNote) {
+    if (midiNote < 0 || midiNote >= kNumNotes)
+        return -1;
+    // The note list runs newest first
+    int slot = noteHead[midiNote];
+    while (slot >= 0 && !slots[slot].sustained)
+        slot = slots[slot].noteNext;
+    if (slot < 0)
+        return -1;
+
+    // Key down again, and the newest note-on
+    slots[slot].sustained = false;
+    unlinkOccupied(slot);
+    linkNewest(slot);
+    return slot;
+}
+
+void VoiceAllocator::setStealRank(int slot, float rank) {
+    Slot& s = slots[slot];
+    if (!s.occupied || rank == s.rank)
+        return;
+    const bool lower = rank < s.rank;
+    s.rank = rank;
+    if (lower) siftUp(s.heapPos);
+    else       siftDown(s.heapPos);
+}
+
+// ============================================================================
+// Intrusive lists
+// ============================================================================
+
+void VoiceAllocator::linkNewest(int slot) {
+    Slot& s = slots[slot];
+    s.occupied = true;
+    s.rank = kFreshRank;
+    s.noteOnSeq = nextNoteOnSeq++;
+    placeInHeap(slot, heapSize++);
+    siftUp(s.heapPos);
+
+    s.prev = newest;
+    s.next = -1;
+    if (newest >= 0)
+        slots[newest].next = slot;
+    else
+        oldest = slot;
+    newest = slot;
+}
+
+void VoiceAllocator::unlinkOccupied(int slot) {
+    Slot& s = slots[slot];
+    if (s.prev >= 0) slots[s.prev].next = s.next;
+    else             oldest = s.next;
+    if (s.next >= 0) slots[s.next].prev = s.prev;
+    else             newest = s.prev;
+    s.prev = s.next = -1;
+    s.occupied = false;
+
+    // Move the heap's last slot into the hole and restore the order
+    const int pos = s.heapPos;
+    const int last = heap[--heapSize];
+    s.heapPos = -1;
+    if (last != slot) {
+        placeInHeap(last, pos);
+        siftUp(pos);
+        siftDown(slots[last].heapPos);
+    }
+}
+
+void VoiceAllocator::hold(int slot, int midiNote) {
+    Slot& s = slots[slot];
+    s.held = true;
+    s.note = midiNote;
+    s.notePrev = -1;
+    s.noteNext = noteHead[midiNote];
+    if (s.noteNext >= 0)
+        slots[s.noteNext].notePrev = slot;
+    noteHead[midiNote] = slot;
+}
+
+void VoiceAllocator::unhold(int slot) {
+    Slot& s = slots[slot];
+    if (s.notePrev >= 0) slots[s.notePrev].noteNext = s.noteNext;
+    else                 noteHead[s.note] = s.noteNext;
+    if (s.noteNext >= 0) slots[s.noteNext].notePrev = s.notePrev;
+    s.notePrev = s.noteNext = -1;
+    s.held = false;
+    s.sustained = false;
+}
+
+void VoiceAllocator::pushFree(int slot) {
+    slots[slot].next = freeHead;
+    slots[slot].prev = -1;
+    freeHead = slot;
+}
+
+// ============================================================================
+// Steal heap
+// ============================================================================
+
+bool VoiceAllocator::stealsBefore(int a, int b) const {
+    const Slot& sa = slots[a];
+    const Slot& sb = slots[b];
+    if (sa.rank != sb.rank)
+        return sa.rank < sb.rank;
+    return static_cast<int32_t>(sa.noteOnSeq - sb.noteOnSeq) < 0;
+}
+
+void VoiceAllocator::placeInHeap(int slot, int pos) {
+    heap[pos] = slot;
+    slots[slot].heapPos = pos;
+}
+
+void VoiceAllocator::siftUp(int pos) {
+    const int slot = heap[pos];
+    while (pos > 0) {
+        const int parent = (pos - 1) / 2;
+        if (!stealsBefore(slot, heap[parent]))
+            break;
+        placeInHeap(heap[parent], pos);
+        pos = parent;
+    }
+    placeInHeap(slot, pos);
+}
+
+void VoiceAllocator::siftDown(int pos) {
+    const int slot = heap[pos];
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= heapSize)
+            break;
+        if (child + 1 < heapSize && stealsBefore(heap[child + 1], heap[child]))
+            ++child;
+        if (!stealsBefore(heap[child], slot))
+            break;
+        placeInHeap(heap[child], pos);
+        pos = child;
+    }
+    placeInHeap(slot, pos);
+}
+
+} // namespace vamos
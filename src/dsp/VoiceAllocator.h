@@ -0,0 +1,292 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace vamos {
+
+// Constant-time voice allocation for Synth.
+//
+// Voices are handed out in slots of slotSize consecutive voices: 1 in Poly,
+// 2 (L/R pair) in Stereo, 4 in Unison. Occupied slots sit in a list ordered
+// by note-on time and in a min-heap ordered by steal rank, so the quietest
+// slot is found in O(1) and re-ranked in O(log n). Synth sets the ranks on
+// control ticks (see setStealRank); equal ranks fall back to the oldest
+// note-on, so with no ranks set the oldest slot is stolen. Free slots sit on
+// a free list. Held slots are also linked into a per-MIDI-note list, so a
+// note-off only visits the slots playing that note. A slot whose key was
+// released under the sustain pedal stays in that list, marked sustained,
+// so replaying the note finds it (restrike) and lifting the pedal
+// releases it.
+//
+// A released slot stays occupied (its voices are still in their release)
+// until Synth reports it silent through reclaim() after rendering.
+class VoiceAllocator {
+public:
+    static constexpr int kMaxSlots = 64;
+    static constexpr int kNumNotes = 128;
+
+    // What regroup() needs to know about each voice
+    struct VoiceState {
+        bool active = false;  // sounding (including release)
+        bool held = false;    // not released (key down or sustained)
+        int note = -1;
+        bool sustained = false;  // key up, held by the sustain pedal
+    };
+
+    // Manage numVoices voices in slots of slotSize, all free
+    void reset(int numVoices, int slotSize);
+
+    int getSlotSize() const { return slotSize; }
+    int getNumSlots() const { return numSlots; }
+    bool isOccupied(int slot) const { return slots[slot].occupied; }
+    bool isHeld(int slot) const { return slots[slot].held; }
+    bool isSustained(int slot) const { return slots[slot].sustained; }
+
+    // The slot most recently allocated or restruck (-1 if none is occupied),
+    // and a slot's note-on count: it changes whenever the slot is allocated
+    // or restruck, so it tells one note-on on a slot from the next
+    int getNewestSlot() const { return newest; }
+    uint32_t getNoteOnSeq(int slot) const { return slots[slot].noteOnSeq; }
+
+    // Take a slot for midiNote: a free one if any, else steal the lowest
+    // ranked (oldest among equals). The slot becomes the newest, is held for
+    // midiNote and ranks above every other until setStealRank() is called.
+    int allocate(int midiNote);
+
+    // Rank an occupied slot for stealing: lower is stolen first
+    void setStealRank(int slot, float rank);
+    static constexpr float kFreshRank = std::numeric_limits<float>::max();
+
+    // Call release(slot) for each held slot playing midiNote and un-hold them
+    template <typename Fn>
+    void releaseNote(int midiNote, Fn&& release);
+
+    // Call release(slot) and un-hold it if slot is held: a note-off for one
+    // note-on rather than for every slot playing its note
+    template <typename Fn>
+    void releaseSlot(int slot, Fn&& release);
+
+    // Call release(slot) for every held slot and un-hold them
+    template <typename Fn>
+    void releaseAll(Fn&& release);
+
+    // Call fn(slot) for each held slot playing midiNote (key down or sustained)
+    template <typename Fn>
+    void forEachHeldSlot(int midiNote, Fn&& fn) const;
+
+    // Call fn(slot) for each occupied slot, oldest note-on first. fn may
+    // re-rank the slot (setStealRank) but not free or allocate slots.
+    template <typename Fn>
+    void forEachOccupiedSlot(Fn&& fn) const;
+
+    // Key-up under the sustain pedal: call sustain(slot) for each held slot
+    // playing midiNote that is not sustained yet, and mark it sustained
+    template <typename Fn>
+    void sustainNote(int midiNote, Fn&& sustain);
+
+    // Key-up under the sustain pedal for one slot: call sustain(slot) and
+    // mark it sustained if it is held and not sustained yet
+    template <typename Fn>
+    void sustainSlot(int slot, Fn&& sustain);
+
+    // Pedal lifted: call release(slot) for every sustained slot and un-hold them
+    template <typename Fn>
+    void releaseSustained(Fn&& release);
+
+    // Replaying a sustained note: take its slot back (the most recently
+    // struck one) as if newly allocated, without stealing. -1 if midiNote
+    // has no sustained slot.
+    int restrike(int midiNote);
+
+    // Free every occupied slot for which isSilent(slot) returns true
+    template <typename Fn>
+    void reclaim(Fn&& isSilent);
+
+    // Change the slot size (voice mode switch) while voices keep playing.
+    // voiceState(voiceIndex) describes each voice; a new slot is occupied if
+    // any of its voices is active. Note-on order is kept where known.
+    template <typename Fn>
+    void regroup(int newSlotSize, Fn&& voiceState);
+
+private:
+    struct Slot {
+        int prev = -1;       // occupied list (towards oldest) / unused when free
+        int next = -1;       // occupied list (towards newest) / free list
+        int notePrev = -1;   // held list for this slot's note
+        int noteNext = -1;
+        int note = -1;
+        bool occupied = false;
+        bool held = false;
+        bool sustained = false;
+        float rank = kFreshRank;
+        uint32_t noteOnSeq = 0;  // wraps; compared as a difference
+        int heapPos = -1;
+    };
+
+    void linkNewest(int slot);
+    void unlinkOccupied(int slot);
+    // Steal heap over the occupied slots
+    bool stealsBefore(int a, int b) const;
+    void siftUp(int pos);
+    void siftDown(int pos);
+    void placeInHeap(int slot, int pos);
+    void hold(int slot, int midiNote);
+    void unhold(int slot);
+    void pushFree(int slot);
+
+    std::array<Slot, kMaxSlots> slots{};
+    std::array<int, kNumNotes> noteHead{};
+    int numVoices = 0;
+    int slotSize = 1;
+    int numSlots = 0;
+    int oldest = -1;
+    int newest = -1;
+    int freeHead = -1;
+    std::array<int, kMaxSlots> heap{};
+    int heapSize = 0;
+    uint32_t nextNoteOnSeq = 0;
+};
+
+// ============================================================================
+// Template members
+// ============================================================================
+
+template <typename Fn>
+void VoiceAllocator::releaseNote(int midiNote, Fn&& release) {
+    if (midiNote < 0 || midiNote >= kNumNotes)
+        return;
+    while (noteHead[midiNote] >= 0) {
+        int slot = noteHead[midiNote];
+        unhold(slot);
+        release(slot);
+    }
+}
+
+template <typename Fn>
+void VoiceAllocator::releaseSlot(int slot, Fn&& release) {
+    if (!slots[slot].held)
+        return;
+    unhold(slot);
+    release(slot);
+}
+
+template <typename Fn>
+void VoiceAllocator::releaseAll(Fn&& release) {
+    for (int slot = oldest; slot >= 0; slot = slots[slot].next) {
+        if (!slots[slot].held) continue;
+        unhold(slot);
+        release(slot);
+    }
+}
+
+template <typename Fn>
+void VoiceAllocator::forEachHeldSlot(int midiNote, Fn&& fn) const {
+    if (midiNote < 0 || midiNote >= kNumNotes)
+        return;
+    for (int slot = noteHead[midiNote]; slot >= 0; slot = slots[slot].noteNext)
+        fn(slot);
+}
+
+template <typename Fn>
+void VoiceAllocator::forEachOccupiedSlot(Fn&& fn) const {
+    for (int slot = oldest; slot >= 0; slot = slots[slot].next)
+        fn(slot);
+}
+
+template <typename Fn>
+void VoiceAllocator::sustainNote(int midiNote, Fn&& sustain) {
+    if (midiNote < 0 || midiNote >= kNumNotes)
+        return;
+    for (int slot = noteHead[midiNote]; slot >= 0; slot = slots[slot].noteNext) {
+        if (slots[slot].sustained) continue;
+        slots[slot].sustained = true;
+        sustain(slot);
+    }
+}
+
+template <typename Fn>
+void VoiceAllocator::sustainSlot(int slot, Fn&& sustain) {
+    if (!slots[slot].held || slots[slot].sustained)
+        return;
+    slots[slot].sustained = true;
+    sustain(slot);
+}
+
+template <typename Fn>
+void VoiceAllocator::releaseSustained(Fn&& release) {
+    for (int slot = oldest; slot >= 0; slot = slots[slot].next) {
+        if (!slots[slot].sustained) continue;
+        unhold(slot);
+        release(slot);
+    }
+}
+
+template <typename Fn>
+void VoiceAllocator::reclaim(Fn&& isSilent) {
+    int slot = oldest;
+    while (slot >= 0) {
+        int next = slots[slot].next;
+        if (isSilent(slot)) {
+            if (slots[slot].held)
+                unhold(slot);
+            unlinkOccupied(slot);
+            pushFree(slot);
+        }
+        slot = next;
+    }
+}
+
+template <typename Fn>
+void VoiceAllocator::regroup(int newSlotSize, Fn&& voiceState) {
+    // Voices in note-on order: each occupied slot's voices, oldest slot
+    // first, then all voices in index order for any the lists didn't cover
+    std::array<int, kMaxSlots> order{};
+    int count = 0;
+    for (int slot = oldest; slot >= 0; slot = slots[slot].next) {
+        for (int i = 0; i < slotSize; ++i)
+            order[count++] = slot * slotSize + i;
+    }
+
+    const int voices = numVoices;
+    reset(voices, newSlotSize);
+    freeHead = -1;
+
+    std::array<bool, kMaxSlots> visited{};
+    auto place = [&](int voice) {
+        int slot = voice / slotSize;
+        if (slot >= numSlots || visited[slot]) return;
+        visited[slot] = true;
+
+        int heldNote = -1;
+        bool sustained = false;
+        bool active = false;
+        for (int i = 0; i < slotSize; ++i) {
+            VoiceState state = voiceState(slot * slotSize + i);
+            active = active || state.active;
+            if (state.active && state.held && heldNote < 0) {
+                heldNote = state.note;
+                sustained = state.sustained;
+            }
+        }
+        if (!active) return;
+
+        linkNewest(slot);
+        if (heldNote >= 0 && heldNote < kNumNotes) {
+            hold(slot, heldNote);
+            slots[slot].sustained = sustained;
+        }
+    };
+
+    for (int i = 0; i < count; ++i)
+        place(order[i]);
+    for (int voice = 0; voice < voices; ++voice)
+        place(voice);
+
+    for (int slot = numSlots - 1; slot >= 0; --slot) {
+        if (!slots[slot].occupied)
+            pushFree(slot);
+    }
+}
+
+} // namespace vamos
@@ -0,0 +1,425 @@
+#include "VoiceLanes.h"
+#include "LaneWaveforms.h"
+#include "Synth.h" // for SynthParams
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace vamos {
+
+// ============================================================================
+// Branch-free per-lane helpers. Everything here is vector arithmetic and
+// selects, one lane per voice.
+// ============================================================================
+
+namespace {
+
+using simd::FloatV;
+using simd::select;
+using simd::laneOscillator;
+using simd::isLaneOscillator;
+
+// The Sallen-Key saturation, with the same kernel as SallenKeyFilter
+inline FloatV laneTanh(FloatV x) { return fastmath::tanh(x); }
+
+// Envelope stages are carried as floats so they live in the same vectors
+constexpr float kStageIdle    = static_cast<float>(Envelope::Stage::Idle);
+constexpr float kStageAttack  = static_cast<float>(Envelope::Stage::Attack);
+constexpr float kStageDecay   = static_cast<float>(Envelope::Stage::Decay);
+constexpr float kStageSustain = static_cast<float>(Envelope::Stage::Sustain);
+constexpr float kStageRelease = static_cast<float>(Envelope::Stage::Release);
+
+} // namespace
+
+bool VoiceLanes::supports(const SynthParams& params) {
+    bool filterOk = params.filterType == FilterType::I
+                 || params.filterType == FilterType::II
+                 || params.filterType == FilterType::LowPass
+                 || params.filterType == FilterType::HighPass;
+    bool noiseSilent = !params.noiseOn || params.noiseLevel <= 0.0f;
+    return isLaneOscillator(params.osc1Type)
+        && isLaneOscillator(params.osc2Type)
+        && filterOk
+        && noiseSilent;
+}
+
+// ============================================================================
+// Render: lane groups of kLaneWidth voices, split into control segments
+// ============================================================================
+
+void VoiceLanes::render(Voice* const* voices, float* const* outputs, int numVoices, int numSamples) {
+    for (int base = 0; base < numVoices; base += kLaneWidth) {
+        int count = std::min(kLaneWidth, numVoices - base);
+        renderGroup(voices + base, outputs + base, count, numSamples);
+    }
+}
+
+void VoiceLanes::renderGroup(Voice* const* voices, float* const* outputs, int numVoices, int numSamples) {
+    int pos = 0;
+    while (pos < numSamples) {
+        // Tick the voices that are due; the segment ends at the next tick of any lane
+        int segment = std::min(numSamples - pos, kMaxSegment);
+        bool anyActive = false;
+        for (int l = 0; l < numVoices; ++l) {
+            Voice& v = *voices[l];
+            if (!v.isActive()) continue;
+            if (v.controlCountdown == 0) {
+                v.tickControl();
+                if (!v.isActive()) continue;  // retired as silent
+            }
+            anyActive = true;
+            segment = std::min(segment, v.controlCountdown);
+        }
+
+        if (!anyActive) {
+            for (int l = 0; l < numVoices; ++l)
+                std::fill(outputs[l] + pos, outputs[l] + numSamples, 0.0f);
+            return;
+        }
+
+        gather(voices, numVoices, segment);
+        renderSegment(segment);
+        scatter(voices, numVoices, segment);
+
+        for (int l = 0; l < numVoices; ++l) {
+            float* dst = outputs[l] + pos;
+            if (laneActive[l]) {
+                for (int i = 0; i < segment; ++i)
+                    dst[i] = out[i][l];
+                voices[l]->trackSilence(dst, nullptr, segment);
+                voices[l]->controlCountdown -= segment;
+            } else {
+                std::fill(dst, dst + segment, 0.0f);
+            }
+        }
+        pos += segment;
+    }
+}
+
+// ============================================================================
+// Gather / scatter between Voice objects and the lane arrays
+// ============================================================================
+
+void VoiceLanes::gather(Voice* const* voices, int numVoices, int numSamples) {
+    const Voice& first = *voices[0];
+    osc1Type = first.osc1.getType();
+    osc2Type = first.osc2.getType();
+    filterType = first.ctl->paramFilterType;
+    sampleRate = first.sampleRate;
+
+    // Prewarped Sallen-Key/SVF coefficient for a cutoff, as Filter::process computes it
+    auto prewarp = [this](Voice& v, float cutoffHz) {
+        float hz = std::clamp(v.filter.applyTracking(cutoffHz, v.currentNote), 20.0f, 20000.0f);
+        return SallenKeyFilter::prewarp(hz, sampleRate);
+    };
+
+    for (int l = 0; l < kLaneWidth; ++l) {
+        laneActive[l] = l < numVoices && voices[l]->isActive();
+        if (!laneActive[l]) {
+            // Silent lane: idle envelope, zero state
+            phase1[l] = inc1[l] = phase2[l] = inc2[l] = 0.0f;
+            freq1[l] = freq1Step[l] = freq2[l] = freq2Step[l] = 0.0f;
+            shape1[l] = shape1Step[l] = shape2[l] = 0.0f;
+            gain1[l] = gain1Step[l] = gain2[l] = gain2Step[l] = 0.0f;
+            g[l] = gStep[l] = res[l] = resStep[l] = 0.0f;
+            cutoff[l] = cutoffStep[l] = 0.0f;
+            s1a[l] = s2a[l] = s1b[l] = s2b[l] = ic1eq[l] = ic2eq[l] = 0.0f;
+            hpFreq[l] = 10.0f;
+            hpFreqStep[l] = hpX1[l] = hpY1[l] = 0.0f;
+            envLevel[l] = envSustain[l] = envAttack[l] = envDecay[l] = envRelease[l] = 0.0f;
+            envStage[l] = kStageIdle;
+            velGain[l] = volume[l] = volumeStep[l] = 0.0f;
+            continue;
+        }
+
+        Voice& v = *voices[l];
+
+        phase1[l] = v.osc1.phasor.phase;
+        inc1[l] = v.osc1.phasor.phaseIncrement;
+        phase2[l] = v.osc2.phasor.phase;
+        inc2[l] = v.osc2.phasor.phaseIncrement;
+        freq1[l] = v.osc1FreqRamp.value;
+        freq1Step[l] = v.osc1FreqRamp.step;
+        freq2[l] = v.osc2FreqRamp.value;
+        freq2Step[l] = v.osc2FreqRamp.step;
+        shape1[l] = v.osc1ShapeRamp.value;
+        shape1Step[l] = v.osc1ShapeRamp.step;
+        shape2[l] = v.osc2.shape;
+
+        // Mixer on/off switches fold into the gains
+        bool osc1On = v.mixer.isOsc1On();
+        bool osc2On = v.mixer.isOsc2On();
+        gain1[l] = osc1On ? v.osc1GainRamp.value : 0.0f;
+        gain1Step[l] = osc1On ? v.osc1GainRamp.step : 0.0f;
+        gain2[l] = osc2On ? v.osc2GainRamp.value : 0.0f;
+        gain2Step[l] = osc2On ? v.osc2GainRamp.step : 0.0f;
+
+        // Interpolate the prewarped coefficient between the segment's endpoints
+        // rather than calling tan() per sample. The filter needs this tick's
+        // type/tracking first, as Voice::renderAudio would have set them.
+        v.filterParams.frequency = v.cutoffRamp.value;
+        v.filterParams.resonance = v.resonanceRamp.value;
+        v.filterParams.hiPassFrequency = v.hiPassRamp.value;
+        v.filter.setParams(v.filterParams);
+        cutoff[l] = v.cutoffRamp.value;
+        cutoffStep[l] = v.cutoffRamp.step;
+        float gStart = prewarp(v, v.cutoffRamp.value);
+        float gEnd = v.cutoffRamp.step != 0.0f
+            ? prewarp(v, v.cutoffRamp.value + v.cutoffRamp.step * static_cast<float>(numSamples))
+            : gStart;
+        // First sample of the segment uses the ramp's first step, like ControlRamp::next()
+        gStep[l] = (gEnd - gStart) / static_cast<float>(numSamples);
+        g[l] = gStart;
+        res[l] = v.resonanceRamp.value;
+        resStep[l] = v.resonanceRamp.step;
+
+        if (filterType == FilterType::II) {
+            s1a[l] = v.filter.sallenKey2a.s1;
+            s2a[l] = v.filter.sallenKey2a.s2;
+            s1b[l] = v.filter.sallenKey2b.s1;
+            s2b[l] = v.filter.sallenKey2b.s2;
+        } else {
+            s1a[l] = v.filter.sallenKey1.s1;
+            s2a[l] = v.filter.sallenKey1.s2;
+        }
+        ic1eq[l] = v.filter.svf.ic1eq;
+        ic2eq[l] = v.filter.svf.ic2eq;
+        hpFreq[l] = v.hiPassRamp.value;
+        hpFreqStep[l] = v.hiPassRamp.step;
+        hpX1[l] = v.filter.hiPassX1;
+        hpY1[l] = v.filter.hiPassY1;
+
+        const Envelope& env = v.ampEnv;
+        envLevel[l] = env.level;
+        envStage[l] = static_cast<float>(env.stage);
+        envSustain[l] = env.params.sustain;
+        envAttack[l] = env.attackCoeff;
+        envDecay[l] = env.decayCoeff;
+        envRelease[l] = env.releaseCoeff;
+
+        velGain[l] = v.velGain;
+        volume[l] = v.volumeRamp.value;
+        volumeStep[l] = v.volumeRamp.step;
+    }
+
+    // Silent lanes are muted and bypassed, so they never keep a block alive.
+    // A falling high-pass ramp stays at or below 10 Hz once it is there.
+    osc1Live = osc2Live = hiPassLive = false;
+    for (int l = 0; l < kLaneWidth; ++l) {
+        osc1Live |= gain1[l] != 0.0f || gain1Step[l] != 0.0f;
+        osc2Live |= gain2[l] != 0.0f || gain2Step[l] != 0.0f;
+        hiPassLive |= hpFreq[l] > 10.0f || hpFreqStep[l] > 0.0f;
+    }
+}
+
+void VoiceLanes::scatter(Voice* const* voices, int numVoices, int /*numSamples*/) {
+    for (int l = 0; l < numVoices; ++l) {
+        if (!laneActive[l]) continue;
+        Voice& v = *voices[l];
+
+        v.osc1.phasor.phase = phase1[l];
+        v.osc1.phasor.phaseIncrement = inc1[l];
+        v.osc2.phasor.phase = phase2[l];
+        v.osc2.phasor.phaseIncrement = inc2[l];
+        v.osc1FreqRamp.value = freq1[l];
+        v.osc2FreqRamp.value = freq2[l];
+        v.osc1ShapeRamp.value = shape1[l];
+        v.osc1.setFrequency(freq1[l]);
+        v.osc2.setFrequency(freq2[l]);
+        v.osc1.setShape(shape1[l]);
+        if (v.mixer.isOsc1On()) v.osc1GainRamp.value = gain1[l];
+        if (v.mixer.isOsc2On()) v.osc2GainRamp.value = gain2[l];
+
+        v.cutoffRamp.value = cutoff[l];
+        v.resonanceRamp.value = res[l];
+        v.hiPassRamp.value = hpFreq[l];
+        v.filterParams.frequency = cutoff[l];
+        v.filterParams.resonance = res[l];
+        v.filterParams.hiPassFrequency = hpFreq[l];
+        v.filter.setParams(v.filterParams);
+
+        if (filterType == FilterType::II) {
+            v.filter.sallenKey2a.s1 = s1a[l];
+            v.filter.sallenKey2a.s2 = s2a[l];
+            v.filter.sallenKey2b.s1 = s1b[l];
+            v.filter.sallenKey2b.s2 = s2b[l];
+        } else {
+            v.filter.sallenKey1.s1 = s1a[l];
+            v.filter.sallenKey1.s2 = s2a[l];
+        }
+        v.filter.svf.ic1eq = ic1eq[l];
+        v.filter.svf.ic2eq = ic2eq[l];
+        v.filter.hiPassX1 = hpX1[l];
+        v.filter.hiPassY1 = hpY1[l];
+
+        v.ampEnv.level = envLevel[l];
+        v.ampEnv.stage = static_cast<Envelope::Stage>(static_cast<int>(envStage[l]));
+        v.volumeRamp.value = volume[l];
+    }
+}
+
+// ============================================================================
+// Kernels: one instantiation per oscillator/filter combination
+// ============================================================================
+
+void VoiceLanes::renderSegment(int numSamples) {
+    switch (osc1Type) {
+        case OscillatorType1::Saw:       dispatchOsc2<OscillatorType1::Saw>(numSamples); break;
+        case OscillatorType1::Rectangle: dispatchOsc2<OscillatorType1::Rectangle>(numSamples); break;
+        default:                         dispatchOsc2<OscillatorType1::Sine>(numSamples); break;
+    }
+}
+
+template <OscillatorType1 Osc1>
+void VoiceLanes::dispatchOsc2(int numSamples) {
+    switch (osc2Type) {
+        case OscillatorType1::Saw:       dispatchFilter<Osc1, OscillatorType1::Saw>(numSamples); break;
+        case OscillatorType1::Rectangle: dispatchFilter<Osc1, OscillatorType1::Rectangle>(numSamples); break;
+        default:                         dispatchFilter<Osc1, OscillatorType1::Sine>(numSamples); break;
+    }
+}
+
+template <OscillatorType1 Osc1, OscillatorType1 Osc2>
+void VoiceLanes::dispatchFilter(int numSamples) {
+    switch (filterType) {
+        case FilterType::II:       renderKernel<Osc1, Osc2, FilterType::II>(numSamples); break;
+        case FilterType::LowPass:  renderKernel<Osc1, Osc2, FilterType::LowPass>(numSamples); break;
+        case FilterType::HighPass: renderKernel<Osc1, Osc2, FilterType::HighPass>(numSamples); break;
+        default:                   renderKernel<Osc1, Osc2, FilterType::I>(numSamples); break;
+    }
+}
+
+template <OscillatorType1 Osc1, OscillatorType1 Osc2, FilterType Type>
+void VoiceLanes::renderKernel(int numSamples) {
+    // Lane state stays in registers for the whole segment
+    auto ld = [](const Lanes& a) { return FloatV::load(a.data()); };
+    FloatV f1 = ld(freq1), f1Step = ld(freq1Step), f2 = ld(freq2), f2Step = ld(freq2Step);
+    FloatV sh1 = ld(shape1), sh1Step = ld(shape1Step), sh2 = ld(shape2);
+    FloatV gn1 = ld(gain1), gn1Step = ld(gain1Step), gn2 = ld(gain2), gn2Step = ld(gain2Step);
+    FloatV gg = ld(g), ggStep = ld(gStep), r = ld(res), rStep = ld(resStep);
+    FloatV hpf = ld(hpFreq), hpfStep = ld(hpFreqStep), x1 = ld(hpX1), y1 = ld(hpY1);
+    FloatV p1 = ld(phase1), p2 = ld(phase2), dt1 = ld(inc1), dt2 = ld(inc2);
+    FloatV sa1 = ld(s1a), sa2 = ld(s2a), sb1 = ld(s1b), sb2 = ld(s2b);
+    FloatV ic1 = ld(ic1eq), ic2 = ld(ic2eq);
+    FloatV level = ld(envLevel), stage = ld(envStage), sus = ld(envSustain);
+    FloatV att = ld(envAttack), dec = ld(envDecay), rel = ld(envRelease);
+    FloatV vel = ld(velGain), vol = ld(volume), volStep = ld(volumeStep);
+
+    const bool live1 = osc1Live, live2 = osc2Live, liveHiPass = hiPassLive;
+
+    const FloatV zero(0.0f), one(1.0f), two(2.0f);
+    const FloatV invSr(1.0f / sampleRate);
+    const FloatV hpDt(1.0f / sampleRate);
+    const FloatV twoPi(2.0f * std::numbers::pi_v<float>);
+
+    for (int i = 0; i < numSamples; ++i) {
+        // --- Control ramps ---
+        f1 = f1 + f1Step;
+        f2 = f2 + f2Step;
+        sh1 = sh1 + sh1Step;
+        gn1 = gn1 + gn1Step;
+        gn2 = gn2 + gn2Step;
+        gg = gg + ggStep;
+        r = r + rStep;
+        hpf = hpf + hpfStep;
+        vol = vol + volStep;
+
+        // --- Phasors (the oscillators see the phase before the increment) ---
+        dt1 = f1 * invSr;
+        FloatV o1 = live1 ? laneOscillator<Osc1>(p1, dt1, sh1) : zero;
+        FloatV np1 = p1 + dt1;
+        np1 = select(np1 >= one, np1 - one, np1);
+        p1 = select(np1 < zero, np1 + one, np1);
+
+        dt2 = f2 * invSr;
+        FloatV o2 = live2 ? laneOscillator<Osc2>(p2, dt2, sh2) : zero;
+        FloatV np2 = p2 + dt2;
+        np2 = select(np2 >= one, np2 - one, np2);
+        p2 = select(np2 < zero, np2 + one, np2);
+
+        // --- Mixer and filter ---
+        FloatV input = gn1 * o1 + gn2 * o2;
+        FloatV k = two * (one - r);
+        FloatV filtered;
+        if constexpr (Type == FilterType::I || Type == FilterType::II) {
+            FloatV g1 = gg / (one + gg);
+            FloatV denom = one + gg * (k + gg);
+
+            FloatV hp = (input - (k + gg) * sa1 - sa2) / denom;
+            FloatV bp = g1 * hp + sa1;
+            FloatV lp = g1 * bp + sa2;
+            sa1 = laneTanh(two * bp - sa1);
+            sa2 = two * lp - sa2;
+            filtered = lp;
+
+            if constexpr (Type == FilterType::II) {
+                FloatV hpB = (lp - (k + gg) * sb1 - sb2) / denom;
+                FloatV bpB = g1 * hpB + sb1;
+                FloatV lpB = g1 * bpB + sb2;
+                sb1 = laneTanh(two * bpB - sb1);
+                sb2 = two * lpB - sb2;
+                filtered = lpB;
+            }
+        } else {
+            FloatV a1 = one / (one + gg * (gg + k));
+            FloatV a2 = gg * a1;
+            FloatV a3 = gg * a2;
+            FloatV v3 = input - ic2;
+            FloatV v1 = a1 * ic1 + a2 * v3;
+            FloatV v2 = ic2 + a2 * ic1 + a3 * v3;
+            ic1 = two * v1 - ic1;
+            ic2 = two * v2 - ic2;
+            if constexpr (Type == FilterType::LowPass)
+                filtered = v2;
+            else
+                filtered = input - k * v1 - v2;
+        }
+
+        // --- Secondary 1-pole high-pass (bypassed at 10 Hz) ---
+        FloatV filterOut = filtered;
+        if (liveHiPass) {
+            FloatV hpClamped = simd::max(FloatV(10.0f), simd::min(FloatV(20000.0f), hpf));
+            FloatV rc = one / (twoPi * hpClamped);
+            FloatV alpha = rc / (rc + hpDt);
+            FloatV hpOut = alpha * (y1 + filtered - x1);
+            auto hpBypass = hpf <= FloatV(10.0f);
+            x1 = select(hpBypass, x1, filtered);
+            y1 = select(hpBypass, y1, hpOut);
+            filterOut = select(hpBypass, filtered, hpOut);
+        }
+
+        // --- Amp envelope: every stage is target + (level - target) * coeff ---
+        auto inAttack = stage == FloatV(kStageAttack);
+        auto inDecay = stage == FloatV(kStageDecay);
+        auto inRelease = stage == FloatV(kStageRelease);
+        auto atSustain = inDecay | (stage == FloatV(kStageSustain));
+        FloatV target = select(inAttack, one, select(atSustain, sus, zero));
+        FloatV coeff = select(inAttack, att, select(inDecay, dec, select(inRelease, rel, zero)));
+        level = target + (level - target) * coeff;
+
+        auto attackDone = inAttack & (level >= FloatV(0.999f));
+        auto decayDone = inDecay & (level <= sus + FloatV(0.0001f));
+        auto releaseDone = inRelease & (level < FloatV(0.0001f));
+        level = select(attackDone, one, select(decayDone, sus, select(releaseDone, zero, level)));
+        stage = select(attackDone, FloatV(kStageDecay),
+                select(decayDone, FloatV(kStageSustain),
+                select(releaseDone, FloatV(kStageIdle), stage)));
+
+        (filterOut * level * vel * vol).store(out[i].data());
+    }
+
+    auto st = [](FloatV x, Lanes& a) { x.store(a.data()); };
+    st(f1, freq1); st(f2, freq2); st(sh1, shape1);
+    st(gn1, gain1); st(gn2, gain2);
+    st(gg, g); st(r, res); st(hpf, hpFreq); st(x1, hpX1); st(y1, hpY1);
+    st(p1, phase1); st(p2, phase2); st(dt1, inc1); st(dt2, inc2);
+    st(sa1, s1a); st(sa2, s2a); st(sb1, s1b); st(sb2, s2b);
+    st(ic1, ic1eq); st(ic2, ic2eq);
+    st(level, envLevel); st(stage, envStage);
+    st(vol, volume);
+    // Cutoff in Hz is only read back by scatter
+    for (int l = 0; l < kLaneWidth; ++l)
+        cutoff[l] += cutoffStep[l] * static_cast<float>(numSamples);
+}
+
+} // namespace vamos
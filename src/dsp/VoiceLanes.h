@@ -0,0 +1,88 @@
+#pragma once
+#include "Voice.h"
+#include "Simd.h"
+#include <array>
+
+namespace vamos {
+
+struct SynthParams;
+
+// Voices rendered side by side in one SIMD lane group.
+// 8 lanes when the DSP layer is built with AVX (VAMOS_ENABLE_AVX2), 4 otherwise
+// (SSE2 on x86-64, NEON on arm64).
+inline constexpr int kLaneWidth = simd::FloatV::size;
+
+// Structure-of-arrays voice engine.
+//
+// Renders the audio-rate part of up to kLaneWidth voices at once: phasors,
+// Saw/Rectangle/Sine oscillators, the Type I/II Sallen-Key and LowPass/HighPass
+// SVF filters, the secondary high-pass and the amp ADSR. Every field lives in
+// a kLaneWidth-wide array; the kernels load them into simd::FloatV registers
+// for a control segment, so each operation runs for all voices at once.
+//
+// Voices stay the owner of their state and control-rate modulation: for each
+// control block the engine ticks the voices that are due, gathers their state
+// into the lane arrays, renders, and scatters the state back. Output matches
+// the scalar Voice path within float tolerance (polynomial sin/tanh, cutoff
+// prewarp interpolated across the control block).
+class VoiceLanes {
+public:
+    // True if every block of this patch has a lane implementation.
+    // Other patches must use the scalar Voice path.
+    static bool supports(const SynthParams& params);
+
+    // Render numSamples of each voice's mono output into outputs[i].
+    // Voices must share oscillator and filter types (one patch).
+    void render(Voice* const* voices, float* const* outputs, int numVoices, int numSamples);
+
+private:
+    using Lanes = std::array<float, kLaneWidth>;
+
+    void renderGroup(Voice* const* voices, float* const* outputs, int numVoices, int numSamples);
+    void gather(Voice* const* voices, int numVoices, int numSamples);
+    void scatter(Voice* const* voices, int numVoices, int numSamples);
+    void renderSegment(int numSamples);
+
+    template <OscillatorType1 Osc1>
+    void dispatchOsc2(int numSamples);
+    template <OscillatorType1 Osc1, OscillatorType1 Osc2>
+    void dispatchFilter(int numSamples);
+    template <OscillatorType1 Osc1, OscillatorType1 Osc2, FilterType Type>
+    void renderKernel(int numSamples);
+
+    OscillatorType1 osc1Type = OscillatorType1::Saw;
+    OscillatorType1 osc2Type = OscillatorType1::Sine;
+    FilterType filterType = FilterType::I;
+    float sampleRate = 44100.0f;
+    std::array<bool, kLaneWidth> laneActive{};
+
+    // Dead blocks for the segment, set by gather(): a source muted in every
+    // lane is not rendered (its phase still advances), and the secondary
+    // high-pass is skipped while every lane bypasses it
+    bool osc1Live = true, osc2Live = true, hiPassLive = true;
+
+    // === Oscillators ===
+    alignas(32) Lanes phase1{}, inc1{}, phase2{}, inc2{};
+    alignas(32) Lanes freq1{}, freq1Step{}, freq2{}, freq2Step{};
+    alignas(32) Lanes shape1{}, shape1Step{}, shape2{};
+
+    // === Mixer ===
+    alignas(32) Lanes gain1{}, gain1Step{}, gain2{}, gain2Step{};
+
+    // === Filter (prewarped cutoff g is interpolated across the segment) ===
+    alignas(32) Lanes cutoff{}, cutoffStep{}, g{}, gStep{}, res{}, resStep{};
+    alignas(32) Lanes s1a{}, s2a{}, s1b{}, s2b{};     // Sallen-Key stage(s)
+    alignas(32) Lanes ic1eq{}, ic2eq{};              // SVF
+    alignas(32) Lanes hpFreq{}, hpFreqStep{}, hpX1{}, hpY1{};
+
+    // === Amp envelope and output gain ===
+    alignas(32) Lanes envLevel{}, envSustain{}, envAttack{}, envDecay{}, envRelease{};
+    alignas(32) Lanes envStage{};   // Envelope::Stage as float
+    alignas(32) Lanes velGain{}, volume{}, volumeStep{};
+
+    // Per-lane output for the current segment
+    static constexpr int kMaxSegment = 256;
+    alignas(32) std::array<Lanes, kMaxSegment> out{};
+};
+
+} // namespace vamos
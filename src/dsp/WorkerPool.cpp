@@ -0,0 +1,170 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#else
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+namespace vamos {
+
+namespace {
+
+// Best effort: without the privilege for it the worker keeps normal priority
+void setRealtimePriority() {
+#if defined(_WIN32)
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL);
+#else
+    sched_param param {};
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 1;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#endif
+}
+
+} // namespace
+
+WorkerPool::~WorkerPool() {
+    stop();
+}
+
+void WorkerPool::start(int threadCount) {
+    stop();
+
+    numThreads = std::max(1, threadCount);
+    queues = std::make_unique<Queue[]>(static_cast<size_t>(numThreads));
+    quit.store(false);
+
+    threads.reserve(static_cast<size_t>(numThreads - 1));
+    for (int t = 1; t < numThreads; ++t)
+        threads.emplace_back([this, t] { workerLoop(t); });
+}
+
+void WorkerPool::stop() {
+    if (!threads.empty()) {
+        quit.store(true);
+        generation.fetch_add(2); // wake sleepers, keep the parity
+        generation.notify_all();
+        for (auto& thread : threads)
+            thread.join();
+        threads.clear();
+    }
+    numThreads = 1;
+    queues = std::make_unique<Queue[]>(1);
+}
+
+// ============================================================================
+// Job queues
+// ============================================================================
+
+bool WorkerPool::popFront(Queue& q, int& jobIndex) {
+    uint64_t range = q.range.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t begin = static_cast<uint32_t>(range >> 32);
+        uint32_t end = static_cast<uint32_t>(range);
+        if (begin >= end)
+            return false;
+        if (q.range.compare_exchange_weak(range, pack(begin + 1, end), std::memory_order_acq_rel)) {
+            jobIndex = static_cast<int>(begin);
+            return true;
+        }
+    }
+}
+
+bool WorkerPool::stealBack(Queue& q, int& jobIndex) {
+    uint64_t range = q.range.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t begin = static_cast<uint32_t>(range >> 32);
+        uint32_t end = static_cast<uint32_t>(range);
+        if (begin >= end)
+            return false;
+        if (q.range.compare_exchange_weak(range, pack(begin, end - 1), std::memory_order_acq_rel)) {
+            jobIndex = static_cast<int>(end - 1);
+            return true;
+        }
+    }
+}
+
+void WorkerPool::drain(int threadIndex) {
+    int jobIndex = 0;
+    while (popFront(queues[threadIndex], jobIndex)) {
+        currentJob(currentContext, jobIndex, threadIndex);
+        pendingJobs.fetch_sub(1, std::memory_order_release);
+    }
+    // Own range done: steal from the others, nearest neighbour first
+    for (int k = 1; k < numThreads; ++k) {
+        Queue& victim = queues[(threadIndex + k) % numThreads];
+        while (stealBack(victim, jobIndex)) {
+            currentJob(currentContext, jobIndex, threadIndex);
+            pendingJobs.fetch_sub(1, std::memory_order_release);
+        }
+    }
+}
+
+// ============================================================================
+// Run / worker loop
+// ============================================================================
+
+void WorkerPool::run(int numJobs, Job job, void* context) {
+    if (numJobs <= 0)
+        return;
+    if (numThreads == 1 || numJobs == 1) {
+        for (int i = 0; i < numJobs; ++i)
+            job(context, i, 0);
+        return;
+    }
+
+    currentJob = job;
+    currentContext = context;
+    pendingJobs.store(numJobs, std::memory_order_relaxed);
+
+    // Contiguous slices, one per thread
+    for (int t = 0; t < numThreads; ++t) {
+        auto begin = static_cast<uint32_t>(t * numJobs / numThreads);
+        auto end = static_cast<uint32_t>((t + 1) * numJobs / numThreads);
+        queues[t].range.store(pack(begin, end), std::memory_order_relaxed);
+    }
+
+    generation.fetch_add(1); // odd: publish the run
+    generation.notify_all();
+
+    drain(0);
+    while (pendingJobs.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+
+    // Even again: workers that wake up late back out without touching the
+    // queues; wait for the ones already inside drain() to leave it
+    generation.fetch_add(1);
+    while (activeWorkers.load() > 0)
+        std::this_thread::yield();
+}
+
+void WorkerPool::workerLoop(int threadIndex) {
+    setRealtimePriority();
+
+    uint32_t seen = generation.load();
+    for (;;) {
+        uint32_t gen = generation.load();
+        while (!quit.load() && (gen == seen || (gen & 1u) == 0)) {
+            generation.wait(gen);
+            gen = generation.load();
+        }
+        if (quit.load())
+            return;
+
+        seen = gen;
+        activeWorkers.fetch_add(1);
+        if (generation.load() == seen)
+            drain(threadIndex);
+        activeWorkers.fetch_sub(1);
+    }
+}
+
+} // namespace vamos
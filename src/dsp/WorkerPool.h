@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace vamos {
+
+// Pre-spawned real-time worker threads for splitting a block's work across
+// cores. run() hands out job indices with lock-free work stealing and
+// returns when every job is done; the calling (audio) thread works too.
+//
+// Each thread owns a range of job indices and pops from its front; a thread
+// that runs dry steals from the back of another thread's range. Nothing in
+// run() allocates or locks. Idle workers sleep on an atomic wait.
+class WorkerPool {
+public:
+    // job(context, jobIndex, threadIndex); threadIndex 0 is the caller
+    using Job = void (*)(void* context, int jobIndex, int threadIndex);
+
+    WorkerPool() = default;
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Spawn threadCount - 1 workers (the caller is thread 0). Stops any running
+    // workers first. Allocates -- call from prepareToPlay, not the audio thread.
+    void start(int threadCount);
+    void stop();
+
+    // Threads taking part in run(), including the caller
+    int getNumThreads() const { return numThreads; }
+
+    // Run job for every index in [0, numJobs) and wait for completion
+    void run(int numJobs, Job job, void* context);
+
+private:
+    // A thread's remaining jobs as [begin, end), packed into one word so the
+    // owner (front) and thieves (back) can both take jobs with a CAS
+    struct alignas(64) Queue {
+        std::atomic<uint64_t> range { 0 };
+    };
+
+    static uint64_t pack(uint32_t begin, uint32_t end) { return (uint64_t(begin) << 32) | end; }
+    bool popFront(Queue& q, int& jobIndex);
+    bool stealBack(Queue& q, int& jobIndex);
+
+    void workerLoop(int threadIndex);
+    void drain(int threadIndex);
+
+    std::vector<std::thread> threads;
+    std::unique_ptr<Queue[]> queues;   // one per thread, caller first
+    int numThreads = 1;
+
+    // Odd while a run() is in progress, even between runs
+    std::atomic<uint32_t> generation { 0 };
+    std::atomic<int> pendingJobs { 0 };
+    std::atomic<int> activeWorkers { 0 };
+    std::atomic<bool> quit { false };
+
+    Job currentJob = nullptr;
+    void* currentContext = nullptr;
+};
+
+} // namespace vamos
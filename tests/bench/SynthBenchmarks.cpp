@@ -0,0 +1,535 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "dsp/FastMath.h"
+#include "dsp/Synth.h"
+#include "dsp/Upsampler.h"
+
+using namespace vamos;
+
+// Engine benchmarks. Not registered with CTest -- run VamosBenchmarks directly:
+//   VamosBenchmarks "[pool]" --benchmark-samples 20
+
+static constexpr float kSampleRate = 48000.0f;
+static constexpr int kBlockSize = 512;
+
+// A synth with numActive held notes in a pool of poolSize voices
+static Synth heldChord(int poolSize, int numActive, bool useLanes) {
+    Synth s;
+    s.setPolyphony(poolSize);
+    s.setSampleRate(kSampleRate);
+    s.setControlBlockSize(16);
+    s.setLaneEngineEnabled(useLanes);
+
+    SynthParams params;
+    params.env1Sustain = 1.0f;
+    params.filterFreq = 3000.0f;
+    params.filterRes = 0.3f;
+    s.setParameters(params);
+
+    for (int n = 0; n < numActive; ++n)
+        s.noteOn(24 + n, 0.8f);
+    return s;
+}
+
+static void benchmarkBlock(const std::string& name, int poolSize, int numActive, bool useLanes) {
+    auto synth = heldChord(poolSize, numActive, useLanes);
+    std::vector<float> left(kBlockSize), right(kBlockSize);
+    BENCHMARK(name.c_str()) {
+        synth.renderBlock(left.data(), right.data(), kBlockSize);
+        return left[0];
+    };
+}
+
+TEST_CASE("Block cost scales with active voices", "[!benchmark][pool]") {
+    for (bool lanes : { false, true }) {
+        for (int active : { 8, 16, 32, 64 }) {
+            benchmarkBlock(std::string(lanes ? "lanes" : "scalar") + ", pool 64, "
+                           + std::to_string(active) + " active", 64, active, lanes);
+        }
+    }
+}
+
+TEST_CASE("Block cost does not depend on pool size", "[!benchmark][pool]") {
+    for (bool lanes : { false, true }) {
+        for (int pool : { 8, 16, 32, 64 }) {
+            benchmarkBlock(std::string(lanes ? "lanes" : "scalar") + ", pool "
+                           + std::to_string(pool) + ", 8 active", pool, 8, lanes);
+        }
+    }
+}
+
+TEST_CASE("Voice lanes vs scalar voices, 8-voice chord", "[!benchmark][lanes]") {
+    // 10 s of an 8-note chord at 48 kHz in 512-sample blocks; the lane
+    // width is whatever the build targets (SSE2/NEON 4, AVX2 8)
+    constexpr int kBlocks = static_cast<int>(10.0f * kSampleRate) / kBlockSize;
+    for (bool lanes : { false, true }) {
+        auto synth = heldChord(8, 8, lanes);
+        std::vector<float> left(kBlockSize), right(kBlockSize);
+        BENCHMARK((std::string(lanes ? "lanes" : "scalar") + ", 10 s").c_str()) {
+            for (int b = 0; b < kBlocks; ++b)
+                synth.renderBlock(left.data(), right.data(), kBlockSize);
+            return left[0];
+        };
+    }
+}
+
+TEST_CASE("Block cost with render threads", "[!benchmark][threads]") {
+    // Heavy case: 8 Unison notes (32 voices) with Type II filters at 192 kHz
+    for (bool lanes : { false, true }) {
+        for (int threads : { 1, 2, 4, 8 }) {
+            Synth synth;
+            synth.setPolyphony(32);
+            synth.setRenderThreads(threads);
+            synth.setSampleRate(192000.0f);
+            synth.setControlBlockSize(64);
+            synth.setLaneEngineEnabled(lanes);
+
+            SynthParams params;
+            params.voiceMode = VoiceMode::Unison;
+            params.filterType = FilterType::II;
+            params.filterFreq = 3000.0f;
+            params.filterRes = 0.3f;
+            params.env1Sustain = 1.0f;
+            synth.setParameters(params);
+            for (int n = 0; n < 8; ++n)
+                synth.noteOn(36 + 5 * n, 0.8f);
+
+            std::vector<float> left(kBlockSize), right(kBlockSize);
+            std::string name = std::string(lanes ? "lanes" : "scalar") + ", "
+                             + std::to_string(threads) + " thread(s)";
+            BENCHMARK(name.c_str()) {
+                synth.renderBlock(left.data(), right.data(), kBlockSize);
+                return left[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("Note event handling", "[!benchmark][events]") {
+    // Dense MIDI: a 64-voice pool kept full while notes come and go
+    auto synth = heldChord(64, 64, false);
+    int note = 0;
+    BENCHMARK("note-on + note-off, full 64-voice pool") {
+        synth.noteOn(note, 0.8f);
+        synth.noteOff((note + 64) % 128);
+        note = (note + 1) % 128;
+        return note;
+    };
+    BENCHMARK("all notes off, 64 voices") {
+        synth.allNotesOff();
+        return synth.getPolyphony();
+    };
+}
+
+TEST_CASE("Block cost of stacked voice modes", "[!benchmark][stacked]") {
+    // 8 Unison notes (32 voices); at control block size 1 the modulators and
+    // mod matrix run every sample, so sharing them across a group shows most
+    for (int controlBlock : { 1, 16 }) {
+        for (bool perVoiceDrift : { true, false }) {
+            Synth synth;
+            synth.setPolyphony(32);
+            synth.setSampleRate(kSampleRate);
+            synth.setControlBlockSize(controlBlock);
+
+            SynthParams params;
+            params.voiceMode = VoiceMode::Unison;
+            params.perVoiceDrift = perVoiceDrift;
+            params.filterFreq = 3000.0f;
+            params.filterRes = 0.3f;
+            params.env1Sustain = 1.0f;
+            synth.setParameters(params);
+            for (int n = 0; n < 8; ++n)
+                synth.noteOn(36 + 5 * n, 0.8f);
+
+            std::vector<float> left(kBlockSize), right(kBlockSize);
+            std::string name = "unison, control block " + std::to_string(controlBlock)
+                             + (perVoiceDrift ? ", per-voice drift" : ", shared drift");
+            BENCHMARK(name.c_str()) {
+                synth.renderBlock(left.data(), right.data(), kBlockSize);
+                return left[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("Unison: stacked voices vs an oscillator stack", "[!benchmark][unison]") {
+    // 8-note chord: classic Unison needs 32 voices, the stack one per note
+    for (int stack : { 0, 4, 8, 16 }) {
+        Synth synth;
+        synth.setPolyphony(stack > 0 ? 8 : 32);
+        synth.setSampleRate(kSampleRate);
+        synth.setControlBlockSize(16);
+        synth.setLaneEngineEnabled(true);
+
+        SynthParams params;
+        params.voiceMode = VoiceMode::Unison;
+        params.unisonStack = stack;
+        params.filterFreq = 3000.0f;
+        params.filterRes = 0.3f;
+        params.env1Sustain = 1.0f;
+        synth.setParameters(params);
+        for (int n = 0; n < 8; ++n)
+            synth.noteOn(36 + 5 * n, 0.8f);
+
+        std::vector<float> left(kBlockSize), right(kBlockSize);
+        std::string name = stack > 0 ? "stack of " + std::to_string(stack) + ", 8 voices"
+                                     : std::string("4 voices per note (lanes), 32 voices");
+        BENCHMARK(name.c_str()) {
+            synth.renderBlock(left.data(), right.data(), kBlockSize);
+            return left[0];
+        };
+    }
+}
+
+TEST_CASE("Muted sources are not rendered", "[!benchmark][dead]") {
+    // 8 held notes with all sources live, osc2 muted, or osc2 switched off
+    const char* variants[] = { "all sources", "osc2 gain 0", "osc2 off" };
+    for (bool lanes : { false, true }) {
+        for (int variant = 0; variant < 3; ++variant) {
+            Synth synth;
+            synth.setSampleRate(kSampleRate);
+            synth.setControlBlockSize(16);
+            synth.setLaneEngineEnabled(lanes);
+
+            SynthParams params;
+            params.env1Sustain = 1.0f;
+            params.filterFreq = 3000.0f;
+            params.filterRes = 0.3f;
+            if (variant == 1) params.osc2Gain = 0.0f;
+            if (variant == 2) params.osc2On = false;
+            synth.setParameters(params);
+            for (int n = 0; n < 8; ++n)
+                synth.noteOn(36 + 5 * n, 0.8f);
+
+            std::vector<float> left(kBlockSize), right(kBlockSize);
+            std::string name = std::string(lanes ? "lanes, " : "scalar, ") + variants[variant];
+            BENCHMARK(name.c_str()) {
+                synth.renderBlock(left.data(), right.data(), kBlockSize);
+                return left[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("Patch kernels vs per-sample type switches", "[!benchmark][kernels]") {
+    // 8 held notes on the scalar voices, one patch per filter family
+    const FilterType filterTypes[] = { FilterType::I, FilterType::II, FilterType::LowPass };
+    for (auto filterType : filterTypes) {
+        for (bool patchKernels : { false, true }) {
+            Synth synth;
+            synth.setSampleRate(kSampleRate);
+            synth.setControlBlockSize(16);
+            synth.setPatchKernelsEnabled(patchKernels);
+
+            SynthParams params;
+            params.osc2Type = OscillatorType1::Rectangle;
+            params.env1Sustain = 1.0f;
+            params.filterType = filterType;
+            params.filterFreq = 3000.0f;
+            params.filterRes = 0.3f;
+            synth.setParameters(params);
+            for (int n = 0; n < 8; ++n)
+                synth.noteOn(36 + 5 * n, 0.8f);
+
+            std::vector<float> left(kBlockSize), right(kBlockSize);
+            std::string name = std::string(patchKernels ? "patch kernel" : "switch") + ", filter "
+                             + std::to_string(static_cast<int>(filterType));
+            BENCHMARK(name.c_str()) {
+                synth.renderBlock(left.data(), right.data(), kBlockSize);
+                return left[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("Parameter publishing", "[!benchmark][params]") {
+    // The processor publishes the full parameter state every block
+    for (int poolSize : { 8, 64 }) {
+        auto synth = heldChord(poolSize, poolSize / 2, false);
+        SynthParams params = synth.getParameters();
+        BENCHMARK(("unchanged parameters, " + std::to_string(poolSize) + " voices").c_str()) {
+            synth.setParameters(params);
+            return params.filterFreq;
+        };
+        BENCHMARK(("one parameter moving, " + std::to_string(poolSize) + " voices").c_str()) {
+            params.filterFreq = params.filterFreq < 3000.0f ? 3001.0f : 2999.0f;
+            synth.setParameters(params);
+            return params.filterFreq;
+        };
+    }
+}
+
+TEST_CASE("Coefficient recomputes per second", "[!benchmark][params]") {
+    // Instrumentation rather than timing: how often derived coefficients are
+    // recomputed over one second of an 8-note chord, published every block
+    auto recomputesPerSecond = [](bool moveCutoff) {
+        auto synth = heldChord(16, 8, false);
+        SynthParams params = synth.getParameters();
+        std::vector<float> left(kBlockSize), right(kBlockSize);
+        for (int i = 0; i < kSampleRate / kBlockSize; ++i)  // settle
+            synth.renderBlock(left.data(), right.data(), kBlockSize);
+        const uint64_t before = synth.getCoefficientRecomputes();
+        int rendered = 0;
+        for (int i = 0; rendered < kSampleRate; ++i, rendered += kBlockSize) {
+            if (moveCutoff)
+                params.filterFreq = 3000.0f + 10.0f * static_cast<float>(i % 2);
+            synth.setParameters(params);
+            synth.renderBlock(left.data(), right.data(), kBlockSize);
+        }
+        return static_cast<double>(synth.getCoefficientRecomputes() - before)
+             * kSampleRate / rendered;
+    };
+    std::printf("coefficient recomputes per second, 8 held notes: %.0f\n", recomputesPerSecond(false));
+    std::printf("coefficient recomputes per second, 8 notes, cutoff moving: %.0f\n", recomputesPerSecond(true));
+}
+
+TEST_CASE("Note-on cost", "[!benchmark][noteon]") {
+    // A note-on must not scale with the sample rate or the filter type: the
+    // comb buffer alone is sr / 20 floats per filter
+    for (float sampleRate : { 48000.0f, 192000.0f }) {
+        Synth synth;
+        synth.setPolyphony(64);
+        synth.setSampleRate(sampleRate);
+        synth.setControlBlockSize(16);
+        SynthParams params;
+        params.filterType = FilterType::Comb;
+        params.env1Sustain = 1.0f;
+        synth.setParameters(params);
+
+        int note = 0;
+        const std::string rate = std::to_string(static_cast<int>(sampleRate / 1000.0f)) + " kHz";
+        BENCHMARK(("note-on, comb filter, " + rate).c_str()) {
+            synth.noteOn(36 + note, 0.8f);
+            note = (note + 1) % 64;
+            return note;
+        };
+
+        // Worst case over a burst of chords: the spike a fast arpeggio causes
+        double worst = 0.0;
+        for (int i = 0; i < 2000; ++i) {
+            auto start = std::chrono::steady_clock::now();
+            synth.noteOn(36 + i % 64, 0.8f);
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            worst = std::max(worst, std::chrono::duration<double, std::micro>(elapsed).count());
+        }
+        std::printf("worst note-on, comb filter, %s: %.2f us\n", rate.c_str(), worst);
+    }
+
+    // Steal path at 192 kHz: a full pool of sounding comb voices, so every
+    // note-on hands a voice to a ghost. The budget sits well above what a
+    // steal costs without touching the delay lines (about 0.1 us median)
+    // and below copying them (about 1.6 us median in this loop).
+    {
+        constexpr double kStealBudgetMicros = 1.0;
+        Synth synth;
+        synth.setPolyphony(8);
+        synth.setSampleRate(192000.0f);
+        synth.setControlBlockSize(16);
+        SynthParams params;
+        params.filterType = FilterType::Comb;
+        params.env1Sustain = 1.0f;
+        synth.setParameters(params);
+        std::vector<float> left(kBlockSize), right(kBlockSize);
+
+        std::vector<double> steals;
+        for (int chord = 0; chord < 250; ++chord) {
+            for (int i = 0; i < 8; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                synth.noteOn(36 + (chord * 8 + i) % 48, 0.8f);
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                if (chord > 0)
+                    steals.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+            }
+            synth.renderBlock(left.data(), right.data(), kBlockSize);
+        }
+        std::sort(steals.begin(), steals.end());
+        const double median = steals[steals.size() / 2];
+        std::printf("stealing note-on, comb filter, 192 kHz: median %.2f us, worst %.2f us\n",
+                    median, steals.back());
+        REQUIRE(median < kStealBudgetMicros);
+    }
+
+    // Stacked unison: one voice per note carrying a 16-copy oscillator stack
+    Synth synth;
+    synth.setPolyphony(64);
+    synth.setSampleRate(48000.0f);
+    synth.setControlBlockSize(16);
+    SynthParams params;
+    params.voiceMode = VoiceMode::Unison;
+    params.unisonStack = OscillatorStack::kMaxSize;
+    params.env1Sustain = 1.0f;
+    synth.setParameters(params);
+
+    int note = 0;
+    BENCHMARK("note-on, 16-copy unison stack") {
+        synth.noteOn(36 + note, 0.8f);
+        note = (note + 1) % 64;
+        return note;
+    };
+}
+
+TEST_CASE("High host rates: direct vs internal rate + upsampler", "[!benchmark][rate]") {
+    // One 512-sample block of a 192 kHz host, 8 held notes
+    constexpr double kHostRate = 192000.0;
+    for (double limit : { 0.0, 96000.0, 48000.0 }) {
+        Upsampler up;
+        up.prepare(Upsampler::factorFor(kHostRate, limit));
+        const int factor = up.getFactor();
+
+        Synth synth;
+        synth.setSampleRate(static_cast<float>(kHostRate / factor));
+        synth.setControlBlockSize(16 * static_cast<int>(kHostRate / factor / 48000.0));
+        SynthParams params;
+        params.env1Sustain = 1.0f;
+        params.filterFreq = 3000.0f;
+        params.filterRes = 0.3f;
+        synth.setParameters(params);
+        for (int n = 0; n < 8; ++n)
+            synth.noteOn(36 + 5 * n, 0.8f);
+
+        std::vector<float> engineL(kBlockSize), engineR(kBlockSize), left(kBlockSize), right(kBlockSize);
+        const std::string name = "192 kHz host, engine at "
+            + std::to_string(static_cast<int>(kHostRate / factor / 1000.0)) + " kHz";
+        BENCHMARK(name.c_str()) {
+            const int needed = up.inputNeeded(kBlockSize);
+            synth.renderBlock(engineL.data(), engineR.data(), needed);
+            up.process(engineL.data(), engineR.data(), needed, left.data(), right.data(), kBlockSize);
+            return left[0];
+        };
+    }
+}
+
+TEST_CASE("Engine cost vs block size", "[!benchmark][buffer]") {
+    // The same 8192 samples of an 8-note chord, rendered in blocks of
+    // 16..2048 samples with the parameters published every block. This is
+    // the engine's share of the per-block cost only; the plugin's
+    // processBlock is measured in PluginTests ("processBlock cost vs buffer size").
+    constexpr int kTotal = 8192;
+    for (bool useLanes : { false, true }) {
+        for (int blockSize : { 16, 32, 64, 128, 256, 512, 1024, 2048 }) {
+            auto synth = heldChord(16, 8, useLanes);
+            SynthParams params = synth.getParameters();
+            std::vector<float> left(blockSize), right(blockSize);
+            const std::string name = std::string(useLanes ? "lanes" : "scalar")
+                + ", " + std::to_string(blockSize) + "-sample blocks";
+            BENCHMARK(name.c_str()) {
+                for (int pos = 0; pos < kTotal; pos += blockSize) {
+                    synth.setParameters(params);
+                    synth.renderBlock(left.data(), right.data(), blockSize);
+                }
+                return left[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("Float vs double output", "[!benchmark][double]") {
+    // A block of a held chord into float buffers, into double buffers, and
+    // into float buffers widened afterwards (what a 64-bit host does for a
+    // float-only plugin)
+    for (bool useLanes : { false, true }) {
+        for (int active : { 8, 32 }) {
+            const std::string suffix = std::string(useLanes ? "lanes, " : "scalar, ")
+                + std::to_string(active) + " voices";
+            {
+                auto synth = heldChord(active, active, useLanes);
+                std::vector<float> left(kBlockSize), right(kBlockSize);
+                BENCHMARK(("float, " + suffix).c_str()) {
+                    synth.renderBlock(left.data(), right.data(), kBlockSize);
+                    return left[0];
+                };
+            }
+            {
+                auto synth = heldChord(active, active, useLanes);
+                std::vector<double> left(kBlockSize), right(kBlockSize);
+                BENCHMARK(("double, " + suffix).c_str()) {
+                    synth.renderBlock(left.data(), right.data(), kBlockSize);
+                    return left[0];
+                };
+            }
+            {
+                auto synth = heldChord(active, active, useLanes);
+                std::vector<float> left(kBlockSize), right(kBlockSize);
+                std::vector<double> hostLeft(kBlockSize), hostRight(kBlockSize);
+                BENCHMARK(("float + host conversion, " + suffix).c_str()) {
+                    synth.renderBlock(left.data(), right.data(), kBlockSize);
+                    std::copy(left.begin(), left.end(), hostLeft.begin());
+                    std::copy(right.begin(), right.end(), hostRight.begin());
+                    return hostLeft[0];
+                };
+            }
+        }
+    }
+}
+
+TEST_CASE("MPE controller stream", "[!benchmark][expression]") {
+    // Per-note bend, pressure and slide for every held note before each
+    // block, as a dense MPE stream sends them, against the block alone
+    for (int active : { 8, 32 }) {
+        const std::string suffix = std::to_string(active) + " voices";
+        {
+            auto synth = heldChord(active, active, true);
+            std::vector<float> left(kBlockSize), right(kBlockSize);
+            BENCHMARK(("block, " + suffix).c_str()) {
+                synth.renderBlock(left.data(), right.data(), kBlockSize);
+                return left[0];
+            };
+        }
+        {
+            auto synth = heldChord(active, active, true);
+            std::vector<float> left(kBlockSize), right(kBlockSize);
+            float x = 0.0f;
+            BENCHMARK(("16 messages per note + block, " + suffix).c_str()) {
+                for (int m = 0; m < 16; ++m) {
+                    x = x < 1.0f ? x + 0.01f : 0.0f;
+                    for (int n = 0; n < active; ++n) {
+                        synth.setNotePitchBend(24 + n, x);
+                        synth.setNotePressure(24 + n, x);
+                        synth.setNoteSlide(24 + n, x);
+                    }
+                }
+                synth.renderBlock(left.data(), right.data(), kBlockSize);
+                return left[0];
+            };
+        }
+    }
+}
+
+TEST_CASE("Fast-math kernels vs <cmath>", "[!benchmark][fastmath]") {
+    // One block of inputs through each function: <cmath>, the scalar kernel
+    // and the vector kernel
+    alignas(32) std::array<float, kBlockSize> in{}, out{};
+    for (int i = 0; i < kBlockSize; ++i)
+        in[i] = -1.5f + 3.0f * static_cast<float>(i) / kBlockSize;
+
+    auto run = [&](const char* name, auto reference, auto scalar, auto vector) {
+        BENCHMARK((std::string(name) + ", <cmath>").c_str()) {
+            for (int i = 0; i < kBlockSize; ++i) out[i] = reference(in[i]);
+            return out[0];
+        };
+        BENCHMARK((std::string(name) + ", scalar kernel").c_str()) {
+            for (int i = 0; i < kBlockSize; ++i) out[i] = scalar(in[i]);
+            return out[0];
+        };
+        BENCHMARK((std::string(name) + ", vector kernel").c_str()) {
+            for (int i = 0; i < kBlockSize; i += simd::FloatV::size)
+                vector(simd::FloatV::load(in.data() + i)).store(out.data() + i);
+            return out[0];
+        };
+    };
+    run("exp2", [](float x) { return std::exp2(x); },
+        [](float x) { return fastmath::exp2(x); }, [](simd::FloatV x) { return fastmath::exp2(x); });
+    run("sin", [](float x) { return std::sin(x); },
+        [](float x) { return fastmath::sin(x); }, [](simd::FloatV x) { return fastmath::sin(x); });
+    run("tan", [](float x) { return std::tan(x); },
+        [](float x) { return fastmath::tan(x); }, [](simd::FloatV x) { return fastmath::tan(x); });
+    run("tanh", [](float x) { return std::tanh(x); },
+        [](float x) { return fastmath::tanh(x); }, [](simd::FloatV x) { return fastmath::tanh(x); });
+}
@@ -0,0 +1,203 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "dsp/FastMath.h"
+#include "dsp/Filter.h"
+#include "dsp/Oscillator.h"
+
+using namespace vamos;
+
+static constexpr float kSampleRate = 48000.0f;
+static constexpr double kPi = std::numbers::pi;
+
+// Largest error of kernel(x) against reference(x) over n + 1 evenly spaced
+// points in [lo, hi], absolute or relative to |reference(x)|
+template <typename Kernel, typename Reference>
+static double maxError(double lo, double hi, int n, Kernel kernel, Reference reference,
+                       bool relative) {
+    double worst = 0.0;
+    for (int i = 0; i <= n; ++i) {
+        const float x = static_cast<float>(lo + (hi - lo) * i / n);
+        const double want = reference(static_cast<double>(x));
+        double err = std::abs(static_cast<double>(kernel(x)) - want);
+        if (relative)
+            err /= std::max(std::abs(want), 1e-30);
+        worst = std::max(worst, err);
+    }
+    return worst;
+}
+
+static double rms(const std::vector<float>& x) {
+    double sum = 0.0;
+    for (float v : x) sum += static_cast<double>(v) * v;
+    return std::sqrt(sum / static_cast<double>(x.size()));
+}
+
+// ============================================================================
+// Error bounds (the table in FastMath.h)
+// ============================================================================
+
+TEST_CASE("exp2 stays within its relative error bound", "[fastmath]") {
+    auto kernel = [](float x) { return fastmath::exp2(x); };
+    auto reference = [](double x) { return std::exp2(x); };
+    CHECK(maxError(-126.0, 126.0, 2000000, kernel, reference, true) < 2e-7);
+    CHECK(maxError(-1.0, 1.0, 200000, kernel, reference, true) < 2e-7);
+    // Out of range inputs clamp rather than overflow
+    CHECK(std::isfinite(fastmath::exp2(1000.0f)));
+    CHECK(fastmath::exp2(-1000.0f) > 0.0f);
+}
+
+TEST_CASE("log2 stays within its absolute error bound", "[fastmath]") {
+    auto kernel = [](float x) { return fastmath::log2(x); };
+    auto reference = [](double x) { return std::log2(x); };
+    CHECK(maxError(0.01, 4.0, 2000000, kernel, reference, false) < 3e-7 * 7.0);
+    CHECK(maxError(0.5, 2.0, 200000, kernel, reference, false) < 3e-7);
+    // Exact at powers of two
+    for (int e = -120; e <= 120; ++e)
+        CHECK(fastmath::log2(std::ldexp(1.0f, e)) == static_cast<float>(e));
+    // Across the whole normal range, scaled by the magnitude of the result
+    double worst = 0.0;
+    for (float x = 1e-37f; x < 1e37f; x *= 1.0137f) {
+        const double want = std::log2(static_cast<double>(x));
+        worst = std::max(worst, std::abs(fastmath::log2(x) - want) / std::max(1.0, std::abs(want)));
+    }
+    CHECK(worst < 3e-7);
+}
+
+TEST_CASE("sin2pi and sin stay within their absolute error bounds", "[fastmath]") {
+    auto turns = [](float x) { return fastmath::sin2pi(x); };
+    CHECK(maxError(-100.0, 100.0, 2000000, turns,
+                   [](double x) { return std::sin(2.0 * kPi * x); }, false) < 3e-7);
+    CHECK(maxError(0.0, 1.0, 200000, turns,
+                   [](double x) { return std::sin(2.0 * kPi * x); }, false) < 3e-7);
+
+    auto radians = [](float x) { return fastmath::sin(x); };
+    auto reference = [](double x) { return std::sin(x); };
+    CHECK(maxError(-2.0 * kPi, 2.0 * kPi, 200000, radians, reference, false) < 7e-7 + 2.0 * kPi * 8e-8);
+    CHECK(maxError(-2000.0 * kPi, 2000.0 * kPi, 2000000, radians, reference, false) < 7e-7 + 2000.0 * kPi * 8e-8);
+}
+
+TEST_CASE("tan stays within its relative error bound", "[fastmath]") {
+    auto kernel = [](float x) { return fastmath::tan(x); };
+    auto reference = [](double x) { return std::tan(x); };
+    CHECK(maxError(-0.5 * kPi + 1e-3, 0.5 * kPi - 1e-3, 2000000, kernel, reference, true) < 3e-7);
+    // The range the filters prewarp: pi * [20 Hz, 0.49 fs] / fs
+    CHECK(maxError(kPi * 20.0 / kSampleRate, kPi * 0.49, 200000, kernel, reference, true) < 3e-7);
+    // One period on, the reduction costs a little absolute accuracy around zero
+    CHECK(maxError(kPi - 1.0, kPi + 1.0, 200000, kernel, reference, false) < 1e-6);
+}
+
+TEST_CASE("tanh stays within its absolute error bound", "[fastmath]") {
+    auto kernel = [](float x) { return fastmath::tanh(x); };
+    auto reference = [](double x) { return std::tanh(x); };
+    CHECK(maxError(-30.0, 30.0, 2000000, kernel, reference, false) < 2e-7);
+    // Small inputs keep their relative accuracy
+    CHECK(maxError(-0.01, 0.01, 200000, kernel, reference, true) < 3e-7);
+    CHECK(fastmath::tanh(1e6f) == 1.0f);
+    CHECK(fastmath::tanh(-1e6f) == -1.0f);
+}
+
+// Same arithmetic, but the compiler may fuse the scalar multiply-adds (FMA)
+// where the intrinsics do not, so allow a couple of ulps
+TEST_CASE("Vector kernels match the scalar kernels in every lane", "[fastmath]") {
+    constexpr int N = simd::FloatV::size;
+    alignas(32) float in[N];
+    alignas(32) float out[N];
+    for (int i = 0; i < 20000; ++i) {
+        for (int l = 0; l < N; ++l)
+            in[l] = -40.0f + 80.0f * static_cast<float>(i * N + l) / (20000.0f * N);
+        auto check = [&](auto vectorKernel, auto scalarKernel) {
+            vectorKernel(simd::FloatV::load(in)).store(out);
+            for (int l = 0; l < N; ++l) {
+                const float want = scalarKernel(in[l]);
+                REQUIRE(std::abs(out[l] - want) <= 5e-7f * std::max(1.0f, std::abs(want)));
+            }
+        };
+        check([](simd::FloatV x) { return fastmath::exp2(x); }, [](float x) { return fastmath::exp2(x); });
+        check([](simd::FloatV x) { return fastmath::sin2pi(x); }, [](float x) { return fastmath::sin2pi(x); });
+        check([](simd::FloatV x) { return fastmath::tan(x); }, [](float x) { return fastmath::tan(x); });
+        check([](simd::FloatV x) { return fastmath::tanh(x); }, [](float x) { return fastmath::tanh(x); });
+        check([](simd::FloatV x) { return fastmath::log2(simd::max(x, simd::FloatV(0.0f)) + simd::FloatV(1e-3f)); },
+              [](float x) { return fastmath::log2(std::max(x, 0.0f) + 1e-3f); });
+    }
+}
+
+// ============================================================================
+// Audible equivalence: the blocks that use the kernels against <cmath>
+// ============================================================================
+
+TEST_CASE("Sine oscillator is indistinguishable from std::sin", "[fastmath]") {
+    for (float freq : { 27.5f, 440.0f, 3520.0f, 15000.0f }) {
+        Oscillator osc;
+        osc.setType(OscillatorType1::Sine);
+        osc.setFrequency(freq);
+        osc.setSampleRate(kSampleRate);
+        Phasor reference;
+        double worst = 0.0;
+        for (int i = 0; i < 48000; ++i) {
+            const float phase = reference.tick(freq, kSampleRate);
+            const double want = std::sin(2.0 * kPi * phase);
+            worst = std::max(worst, std::abs(osc.process() - want));
+        }
+        // Below -120 dBFS
+        CHECK(worst < 1e-6);
+    }
+}
+
+TEST_CASE("Filter prewarp and keyboard tracking keep their pitch", "[fastmath]") {
+    // Cutoff error of the prewarp in cents
+    double worstCents = 0.0;
+    for (float hz = 20.0f; hz < 0.49f * kSampleRate; hz *= 1.01f) {
+        const double g = SallenKeyFilter::prewarp(hz, kSampleRate);
+        const double actualHz = std::atan(g) * kSampleRate / kPi;
+        worstCents = std::max(worstCents, std::abs(1200.0 * std::log2(actualHz / hz)));
+    }
+    CHECK(worstCents < 1e-3);
+
+    // exp2 as a pitch ratio across +-10 octaves
+    worstCents = 0.0;
+    for (float semis = -120.0f; semis <= 120.0f; semis += 0.01f) {
+        const double ratio = math::exp2(semis / 12.0f);
+        worstCents = std::max(worstCents, std::abs(1200.0 * std::log2(ratio) - 100.0 * semis));
+    }
+    CHECK(worstCents < 1e-3);
+}
+
+TEST_CASE("Saturating Sallen-Key filter is indistinguishable from std::tanh", "[fastmath]") {
+    // The filter's own recurrence, written with <cmath>
+    struct Reference {
+        double s1 = 0.0, s2 = 0.0;
+        float process(float input, float cutoffHz, float resonance) {
+            const double g = std::tan(kPi * cutoffHz / kSampleRate);
+            const double k = 2.0 * (1.0 - resonance);
+            const double g1 = g / (1.0 + g);
+            const double hp = (input - (k + g) * s1 - s2) / (1.0 + g * (k + g));
+            const double bp = g1 * hp + s1;
+            const double lp = g1 * bp + s2;
+            s1 = std::tanh(2.0 * bp - s1);
+            s2 = 2.0 * lp - s2;
+            return static_cast<float>(lp);
+        }
+    };
+
+    for (float resonance : { 0.0f, 0.7f, 0.95f }) {
+        SallenKeyFilter filter;
+        Reference reference;
+        Phasor phasor;
+        std::vector<float> out, diff;
+        for (int i = 0; i < 48000; ++i) {
+            // A hot saw into a swept cutoff drives the saturation hard
+            const float in = 3.0f * (2.0f * phasor.tick(110.0f, kSampleRate) - 1.0f);
+            const float cutoff = 200.0f * std::exp2(6.0f * static_cast<float>(i) / 48000.0f);
+            const float got = filter.process(in, cutoff, resonance, kSampleRate);
+            const float want = reference.process(in, cutoff, resonance);
+            out.push_back(want);
+            diff.push_back(got - want);
+        }
+        // The residual sits more than 100 dB below the signal
+        INFO("resonance " << resonance);
+        CHECK(rms(diff) < rms(out) * 1e-5);
+    }
+}
@@ -153,3 +153,33 @@ TEST_CASE("Sallen-Key filter with high resonance doesn't blow up", "[filter][res
     // Should produce some resonant ringing but not explode
     REQUIRE(maxOutput < 100.0f);
 }
+
+TEST_CASE("Comb filter after reset matches a fresh filter", "[filter][reset]") {
+    // The comb buffer is cleared lazily; stale samples must never be read
+    FilterParams params;
+    params.type = FilterType::Comb;
+    params.frequency = 300.0f;
+    params.resonance = 0.9f;
+
+    Filter used;
+    used.setSampleRate(kSampleRate);
+    used.setParams(params);
+    for (int i = 0; i < 5000; ++i) {
+        float input = sineSample(440.0f, i, kSampleRate);
+        used.process(input, input, input, 60);
+    }
+    used.reset();
+
+    Filter fresh;
+    fresh.setSampleRate(kSampleRate);
+    fresh.setParams(params);
+
+    // Sweep the delay over the whole buffer, past the first wrap-around
+    for (int i = 0; i < 6000; ++i) {
+        params.frequency = 20.0f + static_cast<float>(i % 1000);
+        used.setParams(params);
+        fresh.setParams(params);
+        float input = sineSample(220.0f, i, kSampleRate);
+        REQUIRE(used.process(input, 0.0f, 0.0f, 60) == fresh.process(input, 0.0f, 0.0f, 60));
+    }
+}
@@ -0,0 +1,133 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "dsp/OscillatorStack.h"
+
+using namespace vamos;
+using Catch::Approx;
+
+static constexpr float kSampleRate = 48000.0f;
+
+struct StackOutput {
+    std::vector<float> left, right;
+};
+
+static StackOutput renderStack(OscillatorStack& stack, float freq, float shape, int numSamples) {
+    StackOutput out{ std::vector<float>(numSamples), std::vector<float>(numSamples) };
+    std::vector<float> freqs(numSamples, freq), shapes(numSamples, shape);
+    // Uneven chunks, as Voice renders control blocks of varying length
+    for (int pos = 0; pos < numSamples; pos += 37) {
+        int n = std::min(37, numSamples - pos);
+        stack.render(freqs.data() + pos, shapes.data() + pos,
+                     out.left.data() + pos, out.right.data() + pos, n);
+    }
+    return out;
+}
+
+TEST_CASE("Stack size is clamped and 0 or 1 turns it off", "[stack]") {
+    OscillatorStack stack;
+    stack.configure(1, 10.0f);
+    REQUIRE(stack.getSize() == 0);
+    stack.configure(7, 10.0f);
+    REQUIRE(stack.getSize() == 7);
+    stack.configure(40, 10.0f);
+    REQUIRE(stack.getSize() == OscillatorStack::kMaxSize);
+}
+
+TEST_CASE("Reconfiguring the spread takes effect, repeating it changes nothing", "[stack]") {
+    auto render = [](std::initializer_list<float> spreads) {
+        OscillatorStack stack;
+        stack.setSampleRate(kSampleRate);
+        stack.setType(OscillatorType1::Saw);
+        for (float spread : spreads)
+            stack.configure(6, spread);
+        stack.resetPhases();
+        return renderStack(stack, 220.0f, 0.0f, 2048);
+    };
+    const auto fresh = render({ 30.0f });
+    const auto changed = render({ 10.0f, 30.0f });
+    const auto repeated = render({ 30.0f, 30.0f, 30.0f });
+    const auto other = render({ 10.0f });
+    REQUIRE(changed.left == fresh.left);
+    REQUIRE(repeated.left == fresh.left);
+    REQUIRE(repeated.right == fresh.right);
+    REQUIRE(other.left != fresh.left);
+}
+
+TEST_CASE("Sine stack matches the Unison spread and pan formula", "[stack]") {
+    for (int size : { 2, 4, 5, 16 }) {
+        const float spread = 7.0f;
+        OscillatorStack stack;
+        stack.setSampleRate(kSampleRate);
+        stack.setType(OscillatorType1::Sine);
+        stack.configure(size, spread);
+        stack.resetPhases();
+        auto out = renderStack(stack, 220.0f, 0.0f, 2000);
+
+        // Reference: copy k at (k - (N-1)/2) * spread cents, panned
+        // (k - (N-1)/2) / (N/2), start phases on the golden-ratio sequence
+        std::vector<double> phase(size), inc(size), gl(size), gr(size);
+        const double centre = 0.5 * (size - 1);
+        for (int k = 0; k < size; ++k) {
+            double offset = k - centre;
+            double pan = offset / (0.5 * size);
+            phase[k] = std::fmod(k * 0.618034, 1.0);
+            inc[k] = 220.0 * std::pow(2.0, offset * spread / 1200.0) / kSampleRate;
+            gl[k] = (1.0 - pan) / std::sqrt(double(size));
+            gr[k] = (1.0 + pan) / std::sqrt(double(size));
+        }
+        for (int i = 0; i < 2000; ++i) {
+            double l = 0.0, r = 0.0;
+            for (int k = 0; k < size; ++k) {
+                double s = std::sin(2.0 * std::numbers::pi * phase[k]);
+                l += s * gl[k];
+                r += s * gr[k];
+                phase[k] = std::fmod(phase[k] + inc[k], 1.0);
+            }
+            REQUIRE(out.left[i] == Approx(l).margin(1e-3));
+            REQUIRE(out.right[i] == Approx(r).margin(1e-3));
+        }
+    }
+}
+
+TEST_CASE("Saw stack keeps about one oscillator's loudness", "[stack]") {
+    for (int size : { 4, 16 }) {
+        OscillatorStack stack;
+        stack.setSampleRate(kSampleRate);
+        stack.setType(OscillatorType1::Saw);
+        stack.configure(size, 10.0f);
+        stack.resetPhases();
+        auto out = renderStack(stack, 110.0f, 0.0f, 48000);
+
+        double sumSq = 0.0;
+        for (size_t i = 0; i < out.left.size(); ++i) {
+            double mid = 0.5 * (out.left[i] + out.right[i]);
+            sumSq += mid * mid;
+        }
+        double rms = std::sqrt(sumSq / out.left.size());
+        const double sawRms = 1.0 / std::sqrt(3.0);
+        REQUIRE(rms > 0.6 * sawRms);
+        REQUIRE(rms < 1.4 * sawRms);
+        REQUIRE(out.left != out.right);
+    }
+}
+
+TEST_CASE("Waveforms without a lane implementation still render", "[stack]") {
+    OscillatorStack stack;
+    stack.setSampleRate(kSampleRate);
+    stack.setType(OscillatorType1::Triangle);
+    stack.configure(6, 10.0f);
+    stack.resetPhases();
+    auto out = renderStack(stack, 220.0f, 0.0f, 4800);
+
+    float peak = 0.0f;
+    for (size_t i = 0; i < out.left.size(); ++i) {
+        REQUIRE(std::isfinite(out.left[i]));
+        REQUIRE(std::isfinite(out.right[i]));
+        peak = std::max(peak, std::abs(out.left[i]));
+    }
+    REQUIRE(peak > 0.1f);
+    REQUIRE(peak < 4.0f);
+}
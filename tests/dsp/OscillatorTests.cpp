@@ -160,3 +160,25 @@ TEST_CASE("Oscillator shape parameter changes output", "[oscillator][shape]") {
     // With different pulse widths, a significant portion of samples should differ
     REQUIRE(diffCount > 50);
 }
+
+TEST_CASE("advance() keeps a muted oscillator's phase", "[oscillator]") {
+    for (int t = 0; t <= static_cast<int>(OscillatorType1::Saturated); ++t) {
+        auto type = static_cast<OscillatorType1>(t);
+        Oscillator rendered, advanced;
+        for (Oscillator* osc : { &rendered, &advanced }) {
+            osc->setType(type);
+            osc->setSampleRate(44100.0f);
+            osc->setFrequency(311.0f);
+            osc->setShape(0.3f);
+            osc->resetPhase();
+        }
+
+        // One renders throughout, the other is muted for a while
+        for (int i = 0; i < 1000; ++i) {
+            rendered.process();
+            advanced.advance();
+        }
+        for (int i = 0; i < 200; ++i)
+            REQUIRE(advanced.process() == rendered.process());
+    }
+}
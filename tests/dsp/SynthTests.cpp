@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <cmath>
+#include <vector>
+#include <tuple>
 #include "dsp/Synth.h"
 
 using namespace vamos;
@@ -214,3 +216,1024 @@ TEST_CASE("Pitch bend is applied to active voices", "[synth][pitchbend]") {
     // Output should differ with pitch bend applied
     REQUIRE(sumNoBend != Approx(sumWithBend).margin(0.01f));
 }
+
+TEST_CASE("renderBlock matches per-sample process", "[synth][block]") {
+    auto render = [](VoiceMode mode, bool useBlocks) {
+        Synth s;
+        s.setSampleRate(kSampleRate);
+
+        SynthParams params;
+        params.env1Attack = 0.001f;
+        params.env1Release = 0.05f;
+        params.driftDepth = 0.0f;
+        params.filterFreq = 2000.0f;
+        params.filterRes = 0.4f;
+        params.voiceMode = mode;
+        s.setParameters(params);
+
+        s.noteOn(60, 1.0f);
+        s.noteOn(67, 0.7f);
+
+        std::vector<float> left(4000), right(4000);
+        // Uneven block sizes, including ones larger than the internal chunk
+        const int blockSizes[] = { 1, 7, 64, 300, 13 };
+        int pos = 0, b = 0;
+        while (pos < 4000) {
+            int n = std::min(blockSizes[b++ % 5], 4000 - pos);
+            if (pos >= 2000 && pos - n < 2000) s.noteOff(60);
+            if (useBlocks) {
+                s.renderBlock(left.data() + pos, right.data() + pos, n);
+            } else {
+                for (int i = 0; i < n; ++i) {
+                    auto [l, r] = s.process();
+                    left[pos + i] = l;
+                    right[pos + i] = r;
+                }
+            }
+            pos += n;
+        }
+        return std::make_pair(left, right);
+    };
+
+    for (auto mode : { VoiceMode::Poly, VoiceMode::Stereo, VoiceMode::Unison }) {
+        auto ref = render(mode, false);
+        auto blk = render(mode, true);
+        for (size_t i = 0; i < ref.first.size(); ++i) {
+            REQUIRE(blk.first[i] == Approx(ref.first[i]).margin(1e-6f));
+            REQUIRE(blk.second[i] == Approx(ref.second[i]).margin(1e-6f));
+        }
+    }
+}
+
+TEST_CASE("renderBlock supports a mono output", "[synth][block]") {
+    auto synth = createSynth();
+    synth.noteOn(60, 1.0f);
+
+    std::vector<float> left(512, 1.0f);
+    synth.renderBlock(left.data(), nullptr, 512);
+
+    float sumAbs = 0.0f;
+    for (float x : left) sumAbs += std::abs(x);
+    REQUIRE(sumAbs > 0.0f);
+}
+
+TEST_CASE("Double-precision renderBlock matches the float mix", "[synth][block][double]") {
+    // The voices are the same in both; only the mix bus precision differs
+    for (int stack : { 0, 7 }) {
+        Synth single = createSynth(), wide = createSynth();
+        for (Synth* s : { &single, &wide }) {
+            SynthParams params = s->getParameters();
+            params.voiceMode = stack ? VoiceMode::Unison : VoiceMode::Poly;
+            params.unisonStack = stack;
+            s->setParameters(params);
+            for (int note : { 48, 55, 60, 64, 67, 71 })
+                s->noteOn(note, 0.9f);
+        }
+
+        std::vector<float> left(1000), right(1000);
+        std::vector<double> leftD(1000), rightD(1000);
+        for (int pos = 0; pos < 1000; pos += 250) {
+            single.renderBlock(left.data() + pos, right.data() + pos, 250);
+            wide.renderBlock(leftD.data() + pos, rightD.data() + pos, 250);
+        }
+
+        double peak = 0.0;
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE(leftD[i] == Approx(left[i]).margin(1e-6));
+            REQUIRE(rightD[i] == Approx(right[i]).margin(1e-6));
+            peak = std::max(peak, std::abs(leftD[i]));
+        }
+        REQUIRE(peak > 0.05);
+    }
+}
+
+TEST_CASE("Polyphony is clamped to the supported pool sizes", "[synth][pool]") {
+    Synth synth;
+    REQUIRE(synth.getPolyphony() == kDefaultVoices);
+
+    synth.setPolyphony(1);
+    REQUIRE(synth.getPolyphony() == kMinVoices);
+    synth.setPolyphony(1000);
+    REQUIRE(synth.getPolyphony() == kMaxVoices);
+    synth.setPolyphony(32);
+    REQUIRE(synth.getPolyphony() == 32);
+    REQUIRE(synth.getVoices().size() == 32);
+}
+
+TEST_CASE("Larger pools hold more notes in every voice mode", "[synth][pool]") {
+    struct Case { VoiceMode mode; int voicesPerNote; };
+    const Case cases[] = {
+        { VoiceMode::Poly, 1 }, { VoiceMode::Stereo, 2 }, { VoiceMode::Unison, 4 }
+    };
+
+    for (auto [mode, voicesPerNote] : cases) {
+        for (int pool : { 16, 32, 64 }) {
+            Synth synth;
+            synth.setPolyphony(pool);
+            synth.setSampleRate(kSampleRate);
+            SynthParams params;
+            params.driftDepth = 0.0f;
+            params.voiceMode = mode;
+            synth.setParameters(params);
+
+            // Fill the pool exactly
+            const int notes = pool / voicesPerNote;
+            for (int n = 0; n < notes; ++n) {
+                synth.noteOn(30 + n, 0.8f);
+                for (int s = 0; s < 10; ++s) synth.process();
+            }
+            REQUIRE(countActiveVoices(synth) == pool);
+
+            // One more note steals the oldest group: note 30 is gone
+            synth.noteOn(30 + notes, 0.8f);
+            synth.process();
+            REQUIRE(countActiveVoices(synth) == pool);
+            int onOldest = 0, onNewest = 0;
+            for (const auto& v : synth.getVoices()) {
+                if (v.getCurrentNote() == 30) ++onOldest;
+                if (v.getCurrentNote() == 30 + notes) ++onNewest;
+            }
+            REQUIRE(onOldest == 0);
+            REQUIRE(onNewest == voicesPerNote);
+        }
+    }
+}
+
+TEST_CASE("Pool size does not change the output of the same notes", "[synth][pool]") {
+    auto render = [](int pool) {
+        Synth synth;
+        synth.setPolyphony(pool);
+        synth.setSampleRate(kSampleRate);
+        synth.setControlBlockSize(16);
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        synth.setParameters(params);
+        for (int n = 0; n < 6; ++n)
+            synth.noteOn(48 + n * 4, 0.7f);
+
+        std::vector<float> left(4096), right(4096);
+        synth.renderBlock(left.data(), right.data(), 4096);
+        return left;
+    };
+
+    auto small = render(8);
+    auto large = render(64);
+    for (size_t i = 0; i < small.size(); ++i)
+        REQUIRE(large[i] == small[i]);
+}
+
+TEST_CASE("Multi-threaded rendering is bit-identical to single-threaded", "[synth][threads]") {
+    auto render = [](VoiceMode mode, bool useLanes, int threads) {
+        Synth synth;
+        synth.setPolyphony(16);
+        synth.setRenderThreads(threads);
+        synth.setSampleRate(kSampleRate);
+        synth.setControlBlockSize(16);
+        synth.setLaneEngineEnabled(useLanes);
+        SynthParams params;
+        params.driftDepth = 0.0f; // drift is randomly seeded per voice
+        params.voiceMode = mode;
+        params.filterType = FilterType::II;
+        params.filterFreq = 2500.0f;
+        params.filterRes = 0.4f;
+        synth.setParameters(params);
+
+        std::vector<float> left(6000), right(6000);
+        int pos = 0, note = 0;
+        while (pos < 6000) {
+            if (note < 12 && pos >= note * 250) synth.noteOn(40 + 3 * note++, 0.8f);
+            if (pos == 3000) synth.noteOff(40);
+            int n = std::min(257, 6000 - pos);
+            synth.renderBlock(left.data() + pos, right.data() + pos, n);
+            pos += n;
+        }
+        return std::make_pair(left, right);
+    };
+
+    for (auto mode : { VoiceMode::Poly, VoiceMode::Unison }) {
+        for (bool useLanes : { false, true }) {
+            auto ref = render(mode, useLanes, 1);
+            for (int threads : { 2, 3, 4 }) {
+                auto mt = render(mode, useLanes, threads);
+                REQUIRE(mt.first == ref.first);
+                REQUIRE(mt.second == ref.second);
+            }
+        }
+    }
+}
+
+TEST_CASE("allNotesOff releases every voice in every mode", "[synth][noteoff]") {
+    for (auto mode : { VoiceMode::Poly, VoiceMode::Mono, VoiceMode::Stereo, VoiceMode::Unison }) {
+        Synth synth;
+        synth.setSampleRate(kSampleRate);
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        params.env1Release = 0.01f;
+        params.voiceMode = mode;
+        synth.setParameters(params);
+
+        for (int n = 0; n < 5; ++n)
+            synth.noteOn(60 + n, 0.8f);
+        for (int s = 0; s < 100; ++s) synth.process();
+        REQUIRE(countActiveVoices(synth) > 0);
+
+        synth.allNotesOff();
+        for (int s = 0; s < 10000; ++s) synth.process();
+        REQUIRE(countActiveVoices(synth) == 0);
+    }
+}
+
+TEST_CASE("Held notes still release after a voice mode switch", "[synth][noteoff]") {
+    Synth synth;
+    synth.setSampleRate(kSampleRate);
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.env1Release = 0.01f;
+    synth.setParameters(params);
+
+    synth.noteOn(60, 0.8f);
+    synth.noteOn(64, 0.8f);
+    for (int s = 0; s < 100; ++s) synth.process();
+
+    params.voiceMode = VoiceMode::Stereo;
+    synth.setParameters(params);
+    synth.noteOn(67, 0.8f); // lands on a free pair
+    for (int s = 0; s < 100; ++s) synth.process();
+    REQUIRE(countActiveVoices(synth) == 4);
+
+    synth.noteOff(60);
+    synth.noteOff(64);
+    synth.noteOff(67);
+    for (int s = 0; s < 10000; ++s) synth.process();
+    REQUIRE(countActiveVoices(synth) == 0);
+}
+
+TEST_CASE("Released voices are reused before held voices are stolen", "[synth][stealing]") {
+    auto synth = createSynth();
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.env1Release = 0.005f;
+    synth.setParameters(params);
+
+    for (int i = 0; i < 8; ++i)
+        synth.noteOn(60 + i, 0.8f);
+    synth.noteOff(63);
+    for (int s = 0; s < 5000; ++s) synth.process(); // 63 has finished
+
+    synth.noteOn(80, 0.8f);
+    for (int s = 0; s < 10; ++s) synth.process();
+    for (int i = 0; i < 8; ++i) {
+        if (i == 3) continue;
+        bool found = false;
+        for (const auto& v : synth.getVoices())
+            found = found || (v.isActive() && v.getCurrentNote() == 60 + i);
+        REQUIRE(found);
+    }
+}
+
+TEST_CASE("Stealing takes a quiet releasing voice before a held one", "[synth][stealing]") {
+    auto synth = createSynth();
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.env1Release = 2.0f;
+    synth.setParameters(params);
+
+    // The bass note is the oldest, but still held; 62 is releasing
+    synth.noteOn(36, 0.8f);
+    for (int i = 1; i < 8; ++i)
+        synth.noteOn(60 + i, 0.8f);
+    for (int s = 0; s < 100; ++s) synth.process();
+    synth.noteOff(62);
+    for (int s = 0; s < 4410; ++s) synth.process();
+
+    synth.noteOn(80, 0.8f);
+    const auto& voices = synth.getVoices();
+    REQUIRE(voices[0].getCurrentNote() == 36);
+    REQUIRE(voices[2].getCurrentNote() == 80);
+}
+
+TEST_CASE("A stolen voice fades out in a ghost voice", "[synth][stealing]") {
+    auto synth = createSynth();
+    for (int i = 0; i < 8; ++i)
+        synth.noteOn(60 + i, 0.8f);
+    for (int s = 0; s < 1000; ++s) synth.process();
+
+    auto soundingGhosts = [&](int note) {
+        int count = 0;
+        for (const auto& v : synth.getGhostVoices())
+            count += v.isActive() && v.getCurrentNote() == note;
+        return count;
+    };
+
+    // All held at the same level: the oldest is stolen and keeps sounding
+    synth.noteOn(80, 0.8f);
+    REQUIRE(synth.getVoices()[0].getCurrentNote() == 80);
+    REQUIRE(soundingGhosts(60) == 1);
+    REQUIRE(countActiveVoices(synth) == 8);
+
+    // ... for a few milliseconds, in both render paths alike
+    std::vector<float> left(256), right(256);
+    synth.renderBlock(left.data(), right.data(), 32);
+    REQUIRE(soundingGhosts(60) == 1);
+    synth.renderBlock(left.data(), right.data(), 256);
+    REQUIRE(soundingGhosts(60) == 0);
+    REQUIRE_FALSE(synth.isSilent());
+}
+
+TEST_CASE("Ghost voices render the same through every path", "[synth][stealing][block]") {
+    auto render = [](bool perSample) {
+        auto synth = createSynth();
+        synth.setControlBlockSize(16);
+        std::vector<float> out;
+        std::vector<float> left(64), right(64);
+        for (int n = 0; n < 24; ++n) {
+            // Release some notes so both releasing and held voices get stolen
+            synth.noteOn(48 + (n * 7) % 36, 0.5f + 0.02f * n);
+            if (n % 3 == 2)
+                synth.noteOff(48 + ((n - 2) * 7) % 36);
+            if (perSample) {
+                for (int s = 0; s < 64; ++s) {
+                    auto [l, r] = synth.process();
+                    out.push_back(l);
+                    out.push_back(r);
+                }
+            } else {
+                synth.renderBlock(left.data(), right.data(), 64);
+                for (int s = 0; s < 64; ++s) {
+                    out.push_back(left[s]);
+                    out.push_back(right[s]);
+                }
+            }
+        }
+        return out;
+    };
+
+    auto reference = render(true);
+    auto block = render(false);
+    for (size_t i = 0; i < reference.size(); ++i)
+        REQUIRE(block[i] == Approx(reference[i]).margin(1e-6f));
+}
+
+static int countHeldVoices(const Synth& s) {
+    int count = 0;
+    for (const auto& v : s.getVoices())
+        count += v.isActive() && v.getAmpEnv().getStage() != Envelope::Stage::Release;
+    return count;
+}
+
+TEST_CASE("Sustain pedal holds released notes until it is lifted", "[synth][sustain]") {
+    for (auto mode : { VoiceMode::Poly, VoiceMode::Mono, VoiceMode::Stereo, VoiceMode::Unison }) {
+        auto synth = createSynth();
+        SynthParams params = synth.getParameters();
+        params.voiceMode = mode;
+        synth.setParameters(params);
+        const int perNote = mode == VoiceMode::Stereo ? 2 : mode == VoiceMode::Unison ? 4 : 1;
+
+        synth.noteOn(60, 0.8f);
+        for (int s = 0; s < 100; ++s) synth.process();
+        synth.setSustainPedal(true);
+        synth.noteOff(60);
+        for (int s = 0; s < 10000; ++s) synth.process();
+        REQUIRE(countHeldVoices(synth) == perNote);
+
+        synth.setSustainPedal(false);
+        REQUIRE(countHeldVoices(synth) == 0);
+        REQUIRE(countActiveVoices(synth) == perNote);  // releasing
+    }
+}
+
+TEST_CASE("Replaying a sustained note re-strikes its own voice", "[synth][sustain]") {
+    auto synth = createSynth();
+    synth.setSustainPedal(true);
+    for (int n = 0; n < 20; ++n) {
+        synth.noteOn(60, 0.5f + 0.02f * n);
+        for (int s = 0; s < 200; ++s) synth.process();
+        synth.noteOff(60);
+        for (int s = 0; s < 200; ++s) synth.process();
+        REQUIRE(countActiveVoices(synth) == 1);
+    }
+
+    // A key still down is not re-struck: the same note twice takes two voices
+    synth.setSustainPedal(false);
+    synth.noteOn(64, 0.8f);
+    synth.noteOn(64, 0.8f);
+    REQUIRE(countHeldVoices(synth) == 2);
+}
+
+TEST_CASE("Pedalled glissandi keep the voices in use bounded", "[synth][sustain][stress]") {
+    auto synth = createSynth();
+    synth.setPolyphony(kMaxVoices);
+    synth.setControlBlockSize(16);
+    synth.setSustainPedal(true);
+
+    // A white-key octave up and down, again and again, with the pedal down
+    const int scale[] = { 60, 62, 64, 65, 67, 69, 71, 72 };
+    std::vector<float> left(128), right(128);
+    int mostVoices = 0;
+    for (int run = 0; run < 50; ++run) {
+        for (int k = 0; k < 8; ++k) {
+            const int note = scale[run % 2 == 0 ? k : 7 - k];
+            synth.noteOn(note, 0.8f);
+            synth.renderBlock(left.data(), right.data(), 64);
+            synth.noteOff(note);
+            synth.renderBlock(left.data(), right.data(), 64);
+            mostVoices = std::max(mostVoices, countActiveVoices(synth));
+        }
+    }
+    REQUIRE(mostVoices == 8);
+    for (const auto& v : synth.getGhostVoices())
+        REQUIRE_FALSE(v.isActive());  // nothing was stolen
+
+    synth.setSustainPedal(false);
+    for (int b = 0; b < 100; ++b)
+        synth.renderBlock(left.data(), right.data(), 128);
+    REQUIRE(synth.isSilent());
+}
+
+TEST_CASE("Sustained notes that decay out of hearing release early", "[synth][sustain]") {
+    auto synth = createSynth();
+    SynthParams params = synth.getParameters();
+    params.env1Decay = 0.05f;
+    params.env1Sustain = 0.0f;
+    synth.setParameters(params);
+
+    synth.setSustainPedal(true);
+    for (int i = 0; i < 4; ++i)
+        synth.noteOn(60 + i, 0.8f);
+    synth.noteOn(70, 0.8f);
+    for (int i = 0; i < 4; ++i)
+        synth.noteOff(60 + i);
+
+    // The pedal is still down, but the sustained notes have gone quiet;
+    // only the key still down (70) keeps its voice
+    std::vector<float> left(512), right(512);
+    for (int b = 0; b < 200; ++b)
+        synth.renderBlock(left.data(), right.data(), 512);
+    REQUIRE(synth.isSustainPedalDown());
+    REQUIRE(countActiveVoices(synth) == 1);
+    REQUIRE(synth.getVoices()[4].getCurrentNote() == 70);
+}
+
+TEST_CASE("Per-note pressure and slide reach only their note, smoothed per tick", "[synth][expression]") {
+    auto synth = createSynth();
+    synth.setControlBlockSize(16);
+    synth.noteOn(60, 0.8f);
+    synth.noteOn(64, 0.8f);
+    std::vector<float> left(512), right(512);
+    synth.renderBlock(left.data(), right.data(), 64);
+
+    // A dense stream between two ticks: only the last value counts
+    for (int i = 0; i <= 100; ++i)
+        synth.setNotePressure(64, i / 100.0f);
+    synth.renderBlock(left.data(), right.data(), 16);
+    const auto& voices = synth.getVoices();
+    const float afterOneTick = voices[1].getModContext().pressure;
+    REQUIRE(afterOneTick > 0.0f);
+    REQUIRE(afterOneTick < 0.5f);
+    REQUIRE(voices[0].getModContext().pressure == 0.0f);
+
+    // Settled well within 10 time constants
+    for (int b = 0; b < 5; ++b)
+        synth.renderBlock(left.data(), right.data(), 512);
+    REQUIRE(voices[1].getModContext().pressure == Approx(1.0f).margin(1e-3f));
+    REQUIRE(voices[0].getModContext().pressure == 0.0f);
+
+    // Expression sent right after a note-on applies from its first tick
+    synth.noteOn(67, 0.8f);
+    synth.setNoteSlide(67, 0.5f);
+    synth.renderBlock(left.data(), right.data(), 16);
+    REQUIRE(voices[2].getModContext().slide == 0.5f);
+    REQUIRE(voices[1].getModContext().slide == 0.0f);
+}
+
+TEST_CASE("Per-note pitch bend moves only its own note", "[synth][expression]") {
+    auto synth = createSynth();
+    synth.setControlBlockSize(16);
+    synth.noteOn(60, 0.8f);
+    synth.noteOn(64, 0.8f);
+    std::vector<float> left(512), right(512);
+    synth.renderBlock(left.data(), right.data(), 512);
+    const auto& voices = synth.getVoices();
+    const float freq60 = voices[0].getOsc1().getFrequency();
+    const float freq64 = voices[1].getOsc1().getFrequency();
+
+    synth.setNotePitchBend(60, 12.0f);
+    for (int b = 0; b < 10; ++b)
+        synth.renderBlock(left.data(), right.data(), 512);
+    REQUIRE(voices[0].getOsc1().getFrequency() == Approx(2.0f * freq60).epsilon(1e-3));
+    REQUIRE(voices[1].getOsc1().getFrequency() == Approx(freq64).epsilon(1e-6));
+}
+
+TEST_CASE("A note handle addresses one note-on, through its release", "[synth][expression]") {
+    auto synth = createSynth();
+    SynthParams params = synth.getParameters();
+    params.env1Release = 2.0f;
+    synth.setParameters(params);
+    synth.setPolyphony(4);
+    synth.setControlBlockSize(16);
+    std::vector<float> left(512), right(512);
+    const auto& voices = synth.getVoices();
+
+    // Two channels on the same note
+    const NoteHandle a = synth.noteOn(60, 0.8f);
+    const NoteHandle b = synth.noteOn(60, 0.8f);
+    REQUIRE(a.slot == 0);
+    REQUIRE(b.slot == 1);
+    synth.renderBlock(left.data(), right.data(), 512);
+    const float freq = voices[0].getOsc1().getFrequency();
+
+    // Releasing one leaves the other held
+    synth.noteOff(a);
+    REQUIRE(voices[0].getAmpEnv().getStage() == Envelope::Stage::Release);
+    REQUIRE(voices[1].getAmpEnv().getStage() != Envelope::Stage::Release);
+
+    // The release tail still follows its own bend, and only it does
+    synth.setNotePitchBend(a, 12.0f);
+    for (int i = 0; i < 10; ++i)
+        synth.renderBlock(left.data(), right.data(), 512);
+    REQUIRE(voices[0].isActive());
+    REQUIRE(voices[0].getOsc1().getFrequency() == Approx(2.0f * freq).epsilon(1e-3));
+    REQUIRE(voices[1].getOsc1().getFrequency() == Approx(freq).epsilon(1e-6));
+
+    // Under the pedal a note-off sustains only its own note-on
+    synth.setSustainPedal(true);
+    synth.noteOff(b);
+    REQUIRE(voices[1].isSustained());
+    synth.setSustainPedal(false);
+    REQUIRE(voices[1].getAmpEnv().getStage() == Envelope::Stage::Release);
+
+    // Once its slot is stolen, the handle no longer reaches it
+    for (int note : { 61, 62, 63 })
+        synth.noteOn(note, 0.8f);
+    REQUIRE(synth.getVoices()[0].getCurrentNote() == 63);
+    synth.setNotePitchBend(a, -12.0f);
+    synth.noteOff(a);
+    REQUIRE(voices[0].getAmpEnv().getStage() != Envelope::Stage::Release);
+    synth.renderBlock(left.data(), right.data(), 512);
+    REQUIRE(voices[0].getOsc1().getFrequency()
+            == Approx(440.0f * std::pow(2.0f, (63 - 69) / 12.0f)).epsilon(1e-3));
+}
+
+TEST_CASE("Mod wheel and channel pressure reach every voice", "[synth][expression]") {
+    for (auto mode : { VoiceMode::Poly, VoiceMode::Unison }) {
+        auto synth = createSynth();
+        SynthParams params = synth.getParameters();
+        params.voiceMode = mode;
+        synth.setParameters(params);
+        synth.noteOn(60, 0.8f);
+        synth.noteOn(64, 0.8f);
+        synth.setModWheel(0.7f);
+        synth.setPressure(0.25f);
+        synth.setNotePressure(64, 0.5f);
+
+        std::vector<float> left(64), right(64);
+        synth.renderBlock(left.data(), right.data(), 64);
+        int active = 0;
+        for (const auto& v : synth.getVoices()) {
+            if (!v.isActive()) continue;
+            ++active;
+            REQUIRE(v.getModContext().modwheel == 0.7f);
+            // The larger of the synth-wide and the per-note pressure
+            REQUIRE(v.getModContext().pressure == (v.getCurrentNote() == 64 ? 0.5f : 0.25f));
+        }
+        REQUIRE(active == (mode == VoiceMode::Unison ? 8 : 2));
+    }
+}
+
+TEST_CASE("Stacked voices reuse their leader's modulation", "[synth][stacked]") {
+    auto synth = createSynth();
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.lfoRate = 5.0f;
+    params.voiceMode = VoiceMode::Unison;
+    synth.setParameters(params);
+
+    synth.noteOn(60, 0.8f);
+    std::vector<float> left(2000), right(2000);
+    synth.renderBlock(left.data(), right.data(), 2000);
+
+    const auto& voices = synth.getVoices();
+    REQUIRE(voices[0].getModEnv().getLevel() > 0.0f);
+    for (int i = 1; i < 4; ++i) {
+        // Same modulation values, but the follower's own modulators never ran
+        REQUIRE(voices[i].getModContext().lfo == voices[0].getModContext().lfo);
+        REQUIRE(voices[i].getModContext().env2Cyc == voices[0].getModContext().env2Cyc);
+        REQUIRE(voices[i].getModEnv().getLevel() == 0.0f);
+    }
+}
+
+TEST_CASE("Shared drift keeps stacked voices at a fixed detune", "[synth][stacked]") {
+    auto synth = createSynth();
+    SynthParams params;
+    params.driftDepth = 1.0f;
+    params.perVoiceDrift = false;
+    params.voiceMode = VoiceMode::Stereo;
+    params.stereoVoiceDepth = 0.1f;
+    synth.setParameters(params);
+
+    synth.noteOn(60, 0.8f);
+    const float expectedRatio = std::pow(2.0f, 20.0f / 1200.0f); // +-10 cents
+    for (int block = 0; block < 20; ++block) {
+        for (int s = 0; s < 1000; ++s) synth.process();
+        const auto& voices = synth.getVoices();
+        float ratio = voices[1].getOsc1().getFrequency() / voices[0].getOsc1().getFrequency();
+        REQUIRE(ratio == Approx(expectedRatio).epsilon(1e-5));
+    }
+}
+
+TEST_CASE("renderBlock matches process across a switch out of a stacked mode", "[synth][stacked]") {
+    auto render = [](bool useBlocks, bool useLanes) {
+        Synth s;
+        s.setSampleRate(kSampleRate);
+        s.setControlBlockSize(16);
+        s.setLaneEngineEnabled(useLanes);
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        params.lfoRate = 3.0f;
+        params.voiceMode = VoiceMode::Unison;
+        s.setParameters(params);
+
+        std::vector<float> left(8000), right(8000);
+        s.noteOn(48, 0.8f);
+        s.noteOn(55, 0.8f);
+        for (int pos = 0; pos < 8000; pos += 100) {
+            if (pos == 2000) {
+                // Former followers keep playing on their own while the new
+                // Poly notes steal voices around them
+                params.voiceMode = VoiceMode::Poly;
+                s.setParameters(params);
+                for (int n = 0; n < 6; ++n)
+                    s.noteOn(60 + 2 * n, 0.8f);
+            }
+            if (useBlocks) {
+                s.renderBlock(left.data() + pos, right.data() + pos, 100);
+            } else {
+                for (int i = 0; i < 100; ++i) {
+                    auto [l, r] = s.process();
+                    left[pos + i] = l;
+                    right[pos + i] = r;
+                }
+            }
+        }
+        return std::make_pair(left, right);
+    };
+
+    auto ref = render(false, false);
+    for (bool useLanes : { false, true }) {
+        auto blk = render(true, useLanes);
+        const float margin = useLanes ? 1e-3f : 1e-6f; // lanes use fast approximations
+        for (size_t i = 0; i < ref.first.size(); ++i) {
+            REQUIRE(blk.first[i] == Approx(ref.first[i]).margin(margin));
+            REQUIRE(blk.second[i] == Approx(ref.second[i]).margin(margin));
+        }
+    }
+}
+
+TEST_CASE("Unison oscillator stack plays a full chord", "[synth][unison][stack]") {
+    auto synth = createSynth();
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.voiceMode = VoiceMode::Unison;
+    params.unisonStack = 8;
+    synth.setParameters(params);
+
+    for (int n = 0; n < 8; ++n)
+        synth.noteOn(48 + 3 * n, 0.8f);
+    for (int s = 0; s < 100; ++s) synth.process();
+
+    REQUIRE(countActiveVoices(synth) == 8);
+    for (const auto& v : synth.getVoices()) {
+        REQUIRE(v.isStereo());
+        REQUIRE(v.getUnisonStackSize() == 8);
+    }
+
+    // Wide stereo image from a single voice per note
+    std::vector<float> left(1000), right(1000);
+    synth.renderBlock(left.data(), right.data(), 1000);
+    REQUIRE(left != right);
+}
+
+TEST_CASE("Unison stack renders the same through every path", "[synth][unison][stack]") {
+    auto render = [](bool useBlocks, bool useLanes, int threads) {
+        Synth s;
+        s.setRenderThreads(threads);
+        s.setSampleRate(kSampleRate);
+        s.setControlBlockSize(16);
+        s.setLaneEngineEnabled(useLanes);
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        params.filterType = FilterType::II;
+        params.filterFreq = 3000.0f;
+        params.filterRes = 0.3f;
+        params.env1Release = 0.05f;
+        params.voiceMode = VoiceMode::Unison;
+        params.unisonStack = 7;
+        s.setParameters(params);
+
+        std::vector<float> left(6000), right(6000);
+        for (int n = 0; n < 5; ++n)
+            s.noteOn(45 + 4 * n, 0.8f);
+        for (int pos = 0; pos < 6000; pos += 150) {
+            if (pos == 3000) {
+                // Stacked voices release while lane-rendered Poly notes start
+                s.noteOff(45);
+                s.noteOff(49);
+                params.voiceMode = VoiceMode::Poly;
+                s.setParameters(params);
+                s.noteOn(72, 0.8f);
+                s.noteOn(76, 0.8f);
+            }
+            if (useBlocks) {
+                s.renderBlock(left.data() + pos, right.data() + pos, 150);
+            } else {
+                for (int i = 0; i < 150; ++i) {
+                    auto [l, r] = s.process();
+                    left[pos + i] = l;
+                    right[pos + i] = r;
+                }
+            }
+        }
+        return std::make_pair(left, right);
+    };
+
+    auto ref = render(false, false, 1);
+    auto blk = render(true, false, 1);
+    for (size_t i = 0; i < ref.first.size(); ++i) {
+        REQUIRE(blk.first[i] == Approx(ref.first[i]).margin(1e-6f));
+        REQUIRE(blk.second[i] == Approx(ref.second[i]).margin(1e-6f));
+    }
+
+    auto lanes = render(true, true, 1);
+    auto lanesThreaded = render(true, true, 3);
+    REQUIRE(lanesThreaded.first == lanes.first);
+    REQUIRE(lanesThreaded.second == lanes.second);
+}
+
+TEST_CASE("Muted sources come back mid-note without a click", "[synth][block]") {
+    auto render = [](bool useBlocks, bool useLanes, int unisonStack) {
+        Synth s;
+        s.setSampleRate(kSampleRate);
+        s.setControlBlockSize(16);
+        s.setLaneEngineEnabled(useLanes);
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        params.osc1Type = OscillatorType1::Sine;
+        params.osc1Gain = 0.0f;
+        params.osc2Gain = 0.0f;
+        params.env1Sustain = 1.0f;
+        params.voiceMode = unisonStack > 0 ? VoiceMode::Unison : VoiceMode::Poly;
+        params.unisonStack = unisonStack;
+        s.setParameters(params);
+
+        std::vector<float> left(6000), right(6000);
+        s.noteOn(57, 0.8f);
+        s.noteOn(64, 0.8f);
+        for (int pos = 0; pos < 6000; pos += 100) {
+            // Everything muted, then each oscillator comes back in turn
+            if (pos == 1000) { params.osc1Gain = 0.5f; s.setParameters(params); }
+            if (pos == 3000) { params.osc2Gain = 0.4f; s.setParameters(params); }
+            if (useBlocks) {
+                s.renderBlock(left.data() + pos, right.data() + pos, 100);
+            } else {
+                for (int i = 0; i < 100; ++i) {
+                    auto [l, r] = s.process();
+                    left[pos + i] = l;
+                    right[pos + i] = r;
+                }
+            }
+        }
+        return std::make_pair(left, right);
+    };
+
+    for (int stack : { 0, 5 }) {
+        auto ref = render(false, false, stack);
+        for (size_t i = 0; i < 1000; ++i)
+            REQUIRE(ref.first[i] == 0.0f);
+
+        // No sample step at an unmute is larger than the steady sound's
+        float steadyStep = 0.0f, switchStep = 0.0f;
+        for (size_t i = 1; i < ref.first.size(); ++i) {
+            float step = std::abs(ref.first[i] - ref.first[i - 1]);
+            bool atSwitch = (i >= 1000 && i < 1100) || (i >= 3000 && i < 3100);
+            if (atSwitch)
+                switchStep = std::max(switchStep, step);
+            else
+                steadyStep = std::max(steadyStep, step);
+        }
+        REQUIRE(steadyStep > 0.0f);
+        REQUIRE(switchStep <= steadyStep);
+
+        for (bool useLanes : { false, true }) {
+            auto blk = render(true, useLanes, stack);
+            const float margin = useLanes ? 1e-3f : 1e-6f; // lanes use fast approximations
+            for (size_t i = 0; i < ref.first.size(); ++i) {
+                REQUIRE(blk.first[i] == Approx(ref.first[i]).margin(margin));
+                REQUIRE(blk.second[i] == Approx(ref.second[i]).margin(margin));
+            }
+        }
+    }
+}
+
+TEST_CASE("Patch kernels match the switch-based path for every patch", "[synth][kernels]") {
+    auto render = [](const SynthParams& params, bool patchKernels) {
+        Synth s;
+        s.setSampleRate(kSampleRate);
+        s.setControlBlockSize(16);
+        s.setPatchKernelsEnabled(patchKernels);
+        s.setParameters(params);
+        s.noteOn(52, 0.9f);
+        s.noteOn(59, 0.6f);
+        std::vector<float> left(1500), right(1500);
+        s.renderBlock(left.data(), right.data(), 1500);
+        return left;
+    };
+
+    for (int osc1 = 0; osc1 <= static_cast<int>(OscillatorType1::Saturated); ++osc1) {
+        for (int osc2 = 0; osc2 <= static_cast<int>(OscillatorType1::Saturated); ++osc2) {
+            for (int filterType = 0; filterType <= static_cast<int>(FilterType::Resampling); ++filterType) {
+                SynthParams params;
+                params.driftDepth = 0.0f;
+                params.osc1Type = static_cast<OscillatorType1>(osc1);
+                params.osc1Shape = 0.4f;
+                params.osc2Type = static_cast<OscillatorType1>(osc2);
+                params.noiseLevel = 0.2f;
+                params.filterType = static_cast<FilterType>(filterType);
+                params.filterFreq = 1200.0f;
+                params.filterRes = 0.5f;
+                params.filterTracking = 0.3f;
+
+                auto ref = render(params, false);
+                auto fixed = render(params, true);
+                for (size_t i = 0; i < ref.size(); ++i)
+                    REQUIRE(fixed[i] == Approx(ref[i]).margin(1e-6f));
+            }
+        }
+    }
+}
+
+TEST_CASE("Silent voices retire at the same sample in every render path", "[synth][silence]") {
+    auto render = [](bool useBlocks, bool useLanes, int threads) {
+        Synth s;
+        s.setRenderThreads(threads);
+        s.setSampleRate(kSampleRate);
+        s.setControlBlockSize(16);
+        s.setLaneEngineEnabled(useLanes);
+        s.setSilenceThreshold(-50.0f);
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        params.env1Release = 1.0f;
+        params.filterFreq = 800.0f;
+        params.voiceMode = VoiceMode::Poly;
+        s.setParameters(params);
+
+        std::vector<float> left(60000), right(60000);
+        for (int n = 0; n < 5; ++n)
+            s.noteOn(40 + 7 * n, 0.2f + 0.15f * static_cast<float>(n));
+        int silentAt = -1;
+        for (int pos = 0; pos < 60000; pos += 100) {
+            if (pos == 2000) s.allNotesOff();
+            if (useBlocks) {
+                s.renderBlock(left.data() + pos, right.data() + pos, 100);
+            } else {
+                for (int i = 0; i < 100; ++i) {
+                    auto [l, r] = s.process();
+                    left[pos + i] = l;
+                    right[pos + i] = r;
+                }
+            }
+            if (silentAt < 0 && s.isSilent()) silentAt = pos + 100;
+        }
+        return std::make_tuple(left, right, silentAt);
+    };
+
+    auto [refL, refR, refSilentAt] = render(false, false, 1);
+    // Retired well before the envelope floor (1 s release: -80 dB after 1.33 s)
+    REQUIRE(refSilentAt > 2000);
+    REQUIRE(refSilentAt < 2000 + 44100);
+    for (int i = refSilentAt; i < 60000; ++i)
+        REQUIRE(refL[static_cast<size_t>(i)] == 0.0f);
+
+    auto [blkL, blkR, blkSilentAt] = render(true, false, 1);
+    REQUIRE(blkSilentAt == refSilentAt);
+    for (size_t i = 0; i < refL.size(); ++i) {
+        REQUIRE(blkL[i] == Approx(refL[i]).margin(1e-6f));
+        REQUIRE(blkR[i] == Approx(refR[i]).margin(1e-6f));
+    }
+
+    auto lanes = render(true, true, 1);
+    auto lanesThreaded = render(true, true, 3);
+    REQUIRE(std::get<2>(lanes) == std::get<2>(lanesThreaded));
+    REQUIRE(std::get<0>(lanes) == std::get<0>(lanesThreaded));
+    for (size_t i = 0; i < refL.size(); ++i)
+        REQUIRE(std::get<0>(lanes)[i] == Approx(refL[i]).margin(1e-3f));
+}
+
+TEST_CASE("Tail length covers the longest release", "[synth][silence]") {
+    for (float release : { 0.05f, 0.6f, 3.0f }) {
+        Synth s = createSynth();
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        params.env1Release = release;
+        params.env1Sustain = 1.0f;
+        params.osc1Gain = 1.0f;
+        params.osc2Gain = 1.0f;
+        s.setParameters(params);
+        s.setSilenceThreshold(-300.0f);  // only the envelope floor ends a note
+
+        s.noteOn(60, 1.0f);
+        for (int i = 0; i < 2000; ++i) s.process();
+        s.noteOff(60);
+        int samples = 0;
+        while (!s.isSilent()) {
+            s.process();
+            ++samples;
+        }
+
+        float tail = s.getTailLengthSeconds();
+        REQUIRE(static_cast<float>(samples) / kSampleRate <= tail);
+        REQUIRE(static_cast<float>(samples) / kSampleRate > 0.9f * (tail - Voice::kSilenceWindowSeconds));
+    }
+}
+
+TEST_CASE("Parameter changes reach voices through the shared block", "[synth][params]") {
+    auto synth = createSynth();
+    synth.noteOn(60, 1.0f);
+    std::vector<float> left(64), right(64);
+    synth.renderBlock(left.data(), right.data(), 64);
+
+    SynthParams params = synth.getParameters();
+    params.lfoShape = LfoShape::Square;
+    params.glideTime = 0.25f;
+    synth.setParameters(params);
+    REQUIRE(synth.getParameters() == params);
+
+    // The sounding voice picks the change up on the next render...
+    const Voice& playing = synth.getVoices()[0];
+    REQUIRE(playing.getLfo().getShape() != LfoShape::Square);
+    synth.renderBlock(left.data(), right.data(), 64);
+    REQUIRE(playing.getLfo().getShape() == LfoShape::Square);
+    REQUIRE(playing.getGlideTime() == Approx(0.25f));
+
+    // ...and an idle voice on its note-on
+    synth.noteOn(64, 1.0f);
+    for (const auto& v : synth.getVoices()) {
+        if (!v.isActive()) continue;
+        REQUIRE(v.getLfo().getShape() == LfoShape::Square);
+        REQUIRE(v.getGlideTime() == Approx(0.25f));
+    }
+}
+
+TEST_CASE("Republishing unchanged parameters does not change the output", "[synth][params]") {
+    // Parameters are re-applied only on a version change, so modulated state
+    // (here the LFO rate) must not depend on how often the host publishes
+    auto render = [](bool publishEveryBlock) {
+        auto synth = createSynth();
+        synth.setControlBlockSize(16);
+        SynthParams params = synth.getParameters();
+        params.lfoRate = 3.0f;
+        synth.setParameters(params);
+        synth.noteOn(57, 1.0f);
+        std::vector<float> left(4096), right(4096);
+        for (int pos = 0; pos < 4096; pos += 256) {
+            if (publishEveryBlock)
+                synth.setParameters(params);
+            synth.renderBlock(left.data() + pos, right.data() + pos, 256);
+        }
+        return left;
+    };
+    REQUIRE(render(true) == render(false));
+}
+
+TEST_CASE("Coefficients are recomputed only when their inputs change", "[synth][params]") {
+    auto synth = createSynth();
+    synth.setControlBlockSize(16);
+    SynthParams params = synth.getParameters();
+    params.filterFreq = 2000.0f;
+    params.filterTracking = 0.5f;
+    params.glideTime = 0.1f;
+    params.lfoShape = LfoShape::Wander;
+    synth.setParameters(params);
+    synth.noteOn(60, 1.0f);
+
+    std::vector<float> left(512), right(512);
+    auto renderSeconds = [&](float seconds) {
+        for (int n = static_cast<int>(seconds * kSampleRate); n > 0; n -= 512) {
+            synth.setParameters(params);  // published every block, as the plugin does
+            synth.renderBlock(left.data(), right.data(), 512);
+        }
+    };
+
+    // Let Env2's filter sweep settle into its sustain
+    renderSeconds(2.0f);
+    const uint64_t settled = synth.getCoefficientRecomputes();
+    renderSeconds(1.0f);
+    REQUIRE(synth.getCoefficientRecomputes() == settled);
+
+    // Moving one parameter recomputes what it feeds, on the next render
+    params.env1Release = 0.3f;
+    renderSeconds(0.1f);
+    REQUIRE(synth.getCoefficientRecomputes() > settled);
+    const uint64_t afterRelease = synth.getCoefficientRecomputes();
+    renderSeconds(1.0f);
+    REQUIRE(synth.getCoefficientRecomputes() == afterRelease);
+}
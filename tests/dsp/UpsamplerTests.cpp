@@ -0,0 +1,104 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <numbers>
+#include <vector>
+#include "dsp/Upsampler.h"
+
+using namespace vamos;
+using Catch::Approx;
+
+static std::vector<float> sine(double freq, double sampleRate, int numSamples) {
+    std::vector<float> x(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+        x[i] = static_cast<float>(std::sin(2.0 * std::numbers::pi * freq * i / sampleRate));
+    return x;
+}
+
+// Amplitude of the freq component of x (single-bin DFT over whole periods)
+static double amplitudeAt(const std::vector<float>& x, int start, int length, double freq, double sampleRate) {
+    double re = 0.0, im = 0.0;
+    for (int i = 0; i < length; ++i) {
+        double w = 2.0 * std::numbers::pi * freq * i / sampleRate;
+        // Hann window keeps the other components' leakage far down
+        double hann = 0.5 - 0.5 * std::cos(2.0 * std::numbers::pi * i / length);
+        re += x[start + i] * hann * std::cos(w);
+        im += x[start + i] * hann * std::sin(w);
+    }
+    return 2.0 * std::sqrt(re * re + im * im) / (0.5 * length);
+}
+
+// Produce numOutput samples from in, chunk output samples per process() call
+static std::vector<float> upsample(Upsampler& up, const std::vector<float>& in, int numOutput, int chunk) {
+    std::vector<float> out(numOutput);
+    int consumed = 0;
+    for (int pos = 0; pos < numOutput; pos += chunk) {
+        int n = std::min(chunk, numOutput - pos);
+        int needed = up.inputNeeded(n);
+        up.process(in.data() + consumed, nullptr, needed, out.data() + pos, nullptr, n);
+        consumed += needed;
+    }
+    return out;
+}
+
+TEST_CASE("Upsampling factor is the smallest power of two under the limit", "[upsampler]") {
+    REQUIRE(Upsampler::factorFor(192000.0, 0.0) == 1);
+    REQUIRE(Upsampler::factorFor(48000.0, 48000.0) == 1);
+    REQUIRE(Upsampler::factorFor(96000.0, 48000.0) == 2);
+    REQUIRE(Upsampler::factorFor(176400.0, 48000.0) == 4);
+    REQUIRE(Upsampler::factorFor(192000.0, 48000.0) == 4);
+    REQUIRE(Upsampler::factorFor(192000.0, 96000.0) == 2);
+    REQUIRE(Upsampler::factorFor(768000.0, 1000.0) == Upsampler::kMaxFactor);
+}
+
+TEST_CASE("Upsampled sine matches the ideal one after the latency", "[upsampler]") {
+    for (int factor : { 2, 4 }) {
+        Upsampler up;
+        up.prepare(factor);
+        const double inRate = 48000.0, outRate = inRate * factor;
+        const int numOutput = 8192;
+        auto in = sine(1000.0, inRate, numOutput / factor + 64);
+        auto out = upsample(up, in, numOutput, 100);
+
+        const int latency = up.getLatencySamples();
+        REQUIRE(latency == Upsampler::kTapsPerPhase / 2 * factor);
+        for (int i = latency + 256; i < numOutput; ++i) {
+            double ideal = std::sin(2.0 * std::numbers::pi * 1000.0 * (i - latency) / outRate);
+            REQUIRE(out[i] == Approx(ideal).margin(2e-3));
+        }
+    }
+}
+
+TEST_CASE("Upsampling rejects the images above the internal Nyquist", "[upsampler]") {
+    Upsampler up;
+    up.prepare(4);
+    const double inRate = 48000.0, outRate = 192000.0;
+    auto in = sine(10000.0, inRate, 4096);
+    auto out = upsample(up, in, 16000, 512);
+
+    // Images of 10 kHz at 48 kHz sit at 48k -/+ 10k and 96k -/+ 10k
+    const int start = 1024, length = 12000;
+    double wanted = amplitudeAt(out, start, length, 10000.0, outRate);
+    REQUIRE(wanted == Approx(1.0).margin(0.01));
+    for (double image : { 38000.0, 58000.0, 86000.0 })
+        REQUIRE(amplitudeAt(out, start, length, image, outRate) < 1e-4 * wanted);  // -80 dB
+}
+
+TEST_CASE("Upsampler output does not depend on the block size", "[upsampler]") {
+    auto in = sine(3000.0, 48000.0, 2000);
+    Upsampler a, b;
+    a.prepare(4);
+    b.prepare(4);
+    auto whole = upsample(a, in, 6000, 6000);
+    auto chunked = upsample(b, in, 6000, 7);
+    REQUIRE(whole == chunked);
+}
+
+TEST_CASE("Factor 1 passes the signal through unchanged", "[upsampler]") {
+    Upsampler up;
+    up.prepare(1);
+    REQUIRE(up.getLatencySamples() == 0);
+    auto in = sine(440.0, 48000.0, 300);
+    auto out = upsample(up, in, 300, 64);
+    REQUIRE(out == std::vector<float>(in.begin(), in.begin() + 300));
+}
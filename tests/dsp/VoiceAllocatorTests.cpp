@@ -0,0 +1,174 @@
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+#include "dsp/VoiceAllocator.h"
+
+using namespace vamos;
+
+static std::vector<int> releaseNote(VoiceAllocator& alloc, int note) {
+    std::vector<int> released;
+    alloc.releaseNote(note, [&](int slot) { released.push_back(slot); });
+    return released;
+}
+
+TEST_CASE("VoiceAllocator hands out free slots in index order", "[allocator]") {
+    VoiceAllocator alloc;
+    alloc.reset(8, 1);
+    REQUIRE(alloc.getNumSlots() == 8);
+    for (int i = 0; i < 8; ++i)
+        REQUIRE(alloc.allocate(60 + i) == i);
+
+    // Stereo pairs and Unison quads
+    alloc.reset(8, 2);
+    REQUIRE(alloc.getNumSlots() == 4);
+    alloc.reset(9, 4);
+    REQUIRE(alloc.getNumSlots() == 2);
+}
+
+TEST_CASE("VoiceAllocator steals the oldest slot when full", "[allocator]") {
+    VoiceAllocator alloc;
+    alloc.reset(4, 1);
+    for (int i = 0; i < 4; ++i)
+        alloc.allocate(60 + i);
+
+    // Slot 0 is oldest, then 1, ... and each steal makes the slot the newest
+    REQUIRE(alloc.allocate(70) == 0);
+    REQUIRE(alloc.allocate(71) == 1);
+    REQUIRE(alloc.allocate(72) == 2);
+    REQUIRE(alloc.allocate(73) == 3);
+    REQUIRE(alloc.allocate(74) == 0);
+
+    // The stolen slot no longer answers to its old note
+    REQUIRE(releaseNote(alloc, 60).empty());
+    REQUIRE(releaseNote(alloc, 74) == std::vector<int>{ 0 });
+}
+
+TEST_CASE("VoiceAllocator steals the lowest ranked slot", "[allocator]") {
+    VoiceAllocator alloc;
+    alloc.reset(4, 1);
+    for (int i = 0; i < 4; ++i)
+        alloc.allocate(60 + i);
+    alloc.setStealRank(0, 2.0f);
+    alloc.setStealRank(1, 0.5f);
+    alloc.setStealRank(2, 1.5f);
+    alloc.setStealRank(3, 0.5f);
+
+    // Equal ranks: the older slot first; a stolen slot ranks above the rest
+    REQUIRE(alloc.allocate(70) == 1);
+    REQUIRE(alloc.allocate(71) == 3);
+    REQUIRE(alloc.allocate(72) == 2);
+    REQUIRE(alloc.allocate(73) == 0);
+
+    // Re-ranking moves a slot both ways
+    alloc.setStealRank(2, 0.1f);
+    alloc.setStealRank(1, 0.2f);
+    alloc.setStealRank(2, 0.3f);
+    REQUIRE(alloc.allocate(74) == 1);
+
+    // Reclaimed slots leave the ranking
+    for (int slot = 0; slot < 4; ++slot)
+        alloc.setStealRank(slot, 1.0f);
+    alloc.setStealRank(0, 0.0f);
+    alloc.reclaim([](int slot) { return slot == 0; });
+    REQUIRE(alloc.allocate(75) == 0);
+    REQUIRE(alloc.allocate(76) == 3);
+}
+
+TEST_CASE("VoiceAllocator releases only the slots holding a note", "[allocator]") {
+    VoiceAllocator alloc;
+    alloc.reset(8, 1);
+    alloc.allocate(60);
+    alloc.allocate(64);
+    alloc.allocate(60); // same note twice
+
+    auto released = releaseNote(alloc, 60);
+    REQUIRE(released.size() == 2);
+    REQUIRE(alloc.isOccupied(0));   // still sounding its release
+    REQUIRE_FALSE(alloc.isHeld(0));
+    REQUIRE(alloc.isHeld(1));
+
+    // A second note-off finds nothing
+    REQUIRE(releaseNote(alloc, 60).empty());
+
+    int count = 0;
+    alloc.releaseAll([&](int) { ++count; });
+    REQUIRE(count == 1);
+    REQUIRE_FALSE(alloc.isHeld(1));
+}
+
+TEST_CASE("VoiceAllocator reuses reclaimed slots before stealing", "[allocator]") {
+    VoiceAllocator alloc;
+    alloc.reset(4, 1);
+    for (int i = 0; i < 4; ++i)
+        alloc.allocate(60 + i);
+
+    releaseNote(alloc, 62);
+    alloc.reclaim([](int slot) { return slot == 2; });
+    REQUIRE_FALSE(alloc.isOccupied(2));
+
+    REQUIRE(alloc.allocate(80) == 2);
+    REQUIRE(alloc.allocate(81) == 0); // full again: oldest
+}
+
+TEST_CASE("VoiceAllocator walks only the occupied slots, oldest first", "[allocator]") {
+    VoiceAllocator alloc;
+    alloc.reset(8, 1);
+    for (int note : { 60, 61, 62, 63 })
+        alloc.allocate(note);
+    releaseNote(alloc, 61);
+    alloc.reclaim([](int slot) { return slot == 1; });
+    alloc.allocate(64);  // takes the reclaimed slot 1, now the newest
+
+    std::vector<int> order;
+    alloc.forEachOccupiedSlot([&](int slot) {
+        order.push_back(slot);
+        alloc.setStealRank(slot, static_cast<float>(order.size()));
+    });
+    REQUIRE(order == std::vector<int>{ 0, 2, 3, 1 });
+
+    // Re-ranking along the way neither skips nor repeats a slot
+    std::vector<int> again;
+    alloc.forEachOccupiedSlot([&](int slot) { again.push_back(slot); });
+    REQUIRE(again == order);
+
+    // The free slots go first, then the lowest rank
+    for (int i = 0; i < 4; ++i)
+        REQUIRE(alloc.allocate(70 + i) == 4 + i);
+    REQUIRE(alloc.allocate(74) == 0);
+}
+
+TEST_CASE("VoiceAllocator regroup keeps sounding voices and held notes", "[allocator]") {
+    VoiceAllocator alloc;
+    alloc.reset(8, 1);
+
+    // Voices 2 and 5 held, voice 6 releasing; as seen by regroup
+    std::vector<VoiceAllocator::VoiceState> voices(8);
+    voices[2] = { true, true, 62 };
+    voices[5] = { true, true, 65 };
+    voices[6] = { true, false, 66 };
+
+    alloc.regroup(2, [&](int idx) { return voices[static_cast<size_t>(idx)]; });
+    REQUIRE(alloc.getNumSlots() == 4);
+    REQUIRE(alloc.isOccupied(1));    // voices 2-3
+    REQUIRE(alloc.isOccupied(2));    // voices 4-5
+    REQUIRE(alloc.isOccupied(3));    // voices 6-7, releasing
+    REQUIRE_FALSE(alloc.isHeld(3));
+    REQUIRE_FALSE(alloc.isOccupied(0));
+
+    REQUIRE(releaseNote(alloc, 65) == std::vector<int>{ 2 });
+    REQUIRE(alloc.allocate(70) == 0); // the only free pair
+}
+
+TEST_CASE("VoiceAllocator state stays bounded over long sessions", "[allocator]") {
+    // No age counter: millions of note-ons keep stealing in strict order
+    VoiceAllocator alloc;
+    alloc.reset(8, 1);
+    for (int i = 0; i < 8; ++i)
+        alloc.allocate(i);
+    for (int i = 0; i < 3000000; ++i) {
+        int slot = alloc.allocate(i % 128);
+        if (slot != i % 8) {
+            REQUIRE(slot == i % 8);
+            break;
+        }
+    }
+}
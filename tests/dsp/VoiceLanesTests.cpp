@@ -0,0 +1,154 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "dsp/Synth.h"
+
+using namespace vamos;
+using Catch::Approx;
+
+static constexpr float kSampleRate = 48000.0f;
+
+struct StereoRender {
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+// Render a chord through the synth, optionally with the voice-lane engine
+static StereoRender renderChord(const SynthParams& params, bool useLanes, int numNotes,
+                                int numSamples = 12000) {
+    Synth s;
+    s.setSampleRate(kSampleRate);
+    s.setControlBlockSize(16);
+    s.setParameters(params);
+    s.setLaneEngineEnabled(useLanes);
+
+    StereoRender out { std::vector<float>(numSamples), std::vector<float>(numSamples) };
+    int pos = 0;
+    int note = 0;
+    while (pos < numSamples) {
+        // Stagger note-ons off the control grid, release one note half way
+        if (note < numNotes && pos >= note * 101) {
+            s.noteOn(48 + note * 3, 0.6f + 0.05f * static_cast<float>(note));
+            ++note;
+        }
+        if (pos == 6000) s.noteOff(48);
+
+        int n = std::min(101, numSamples - pos);
+        s.renderBlock(out.left.data() + pos, out.right.data() + pos, n);
+        pos += n;
+    }
+    return out;
+}
+
+static void requireClose(const StereoRender& ref, const StereoRender& test) {
+    float errSq = 0.0f, refSq = 0.0f, maxErr = 0.0f;
+    for (size_t i = 0; i < ref.left.size(); ++i) {
+        float dl = test.left[i] - ref.left[i];
+        float dr = test.right[i] - ref.right[i];
+        errSq += dl * dl + dr * dr;
+        refSq += ref.left[i] * ref.left[i] + ref.right[i] * ref.right[i];
+        maxErr = std::max({ maxErr, std::abs(dl), std::abs(dr) });
+    }
+    REQUIRE(refSq > 0.0f);
+    REQUIRE(errSq / refSq < 1.0e-6f); // residual below -60 dB
+    REQUIRE(maxErr < 1.0e-3f);
+}
+
+TEST_CASE("VoiceLanes supports only lane-implemented blocks", "[lanes]") {
+    SynthParams params;
+    REQUIRE(VoiceLanes::supports(params));
+
+    params.osc1Type = OscillatorType1::Triangle;
+    REQUIRE_FALSE(VoiceLanes::supports(params));
+
+    params = SynthParams{};
+    params.filterType = FilterType::Comb;
+    REQUIRE_FALSE(VoiceLanes::supports(params));
+
+    params = SynthParams{};
+    params.noiseLevel = 0.5f;
+    REQUIRE_FALSE(VoiceLanes::supports(params));
+    params.noiseOn = false;
+    REQUIRE(VoiceLanes::supports(params));
+}
+
+TEST_CASE("Voice lanes match the scalar engine", "[lanes]") {
+    const OscillatorType1 oscTypes[] = {
+        OscillatorType1::Saw, OscillatorType1::Rectangle, OscillatorType1::Sine
+    };
+    const FilterType filterTypes[] = {
+        FilterType::I, FilterType::II, FilterType::LowPass, FilterType::HighPass
+    };
+
+    for (auto osc : oscTypes) {
+        for (auto filterType : filterTypes) {
+            SECTION("Osc " + std::to_string(static_cast<int>(osc))
+                    + " filter " + std::to_string(static_cast<int>(filterType))) {
+                SynthParams params;
+                params.driftDepth = 0.0f;
+                params.osc1Type = osc;
+                params.osc2Type = OscillatorType1::Saw;
+                params.filterType = filterType;
+                params.filterFreq = 1500.0f;
+                params.filterRes = 0.5f;
+                params.filterTracking = 0.5f;
+                params.env1Attack = 0.01f;
+                params.env1Decay = 0.1f;
+                params.env1Sustain = 0.6f;
+                params.env1Release = 0.05f;
+
+                // 8 notes fill whole lane groups; 5 leaves lanes empty
+                for (int notes : { 8, 5 }) {
+                    auto ref = renderChord(params, false, notes);
+                    auto lanes = renderChord(params, true, notes);
+                    requireClose(ref, lanes);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Voice lanes match the scalar engine in Stereo and Unison modes", "[lanes]") {
+    for (auto mode : { VoiceMode::Stereo, VoiceMode::Unison }) {
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        params.voiceMode = mode;
+        params.osc1Shape = 0.3f;
+        params.filterFreq = 3000.0f;
+        params.filterRes = 0.2f;
+
+        auto ref = renderChord(params, false, 4);
+        auto lanes = renderChord(params, true, 4);
+        requireClose(ref, lanes);
+    }
+}
+
+TEST_CASE("Unsupported patches fall back to the scalar engine", "[lanes]") {
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.osc1Type = OscillatorType1::SharkTooth;
+    params.filterType = FilterType::Vowel;
+
+    auto ref = renderChord(params, false, 3);
+    auto lanes = renderChord(params, true, 3);
+    for (size_t i = 0; i < ref.left.size(); ++i)
+        REQUIRE(lanes.left[i] == ref.left[i]);
+}
+
+TEST_CASE("Voice lanes match the scalar engine with muted sources", "[lanes]") {
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.filterFreq = 2500.0f;
+    params.filterRes = 0.3f;
+
+    SECTION("Osc 2 at zero gain") {
+        params.osc2Gain = 0.0f;
+        requireClose(renderChord(params, false, 6), renderChord(params, true, 6));
+    }
+    SECTION("Osc 1 switched off") {
+        params.osc1On = false;
+        requireClose(renderChord(params, false, 6), renderChord(params, true, 6));
+    }
+}
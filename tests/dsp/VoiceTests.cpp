@@ -1,6 +1,8 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
 #include <cmath>
+#include <vector>
+#include <algorithm>
 #include "dsp/Synth.h" // Includes Voice.h + SynthParams
 
 using namespace vamos;
@@ -162,6 +164,63 @@ TEST_CASE("Glide smoothly interpolates frequency", "[voice][glide]") {
     REQUIRE(v.isActive() == true);
 }
 
+TEST_CASE("Glide moves at the same rate in semitones for any interval", "[voice][glide]") {
+    // Fraction of the interval covered 50 ms into a 200 ms glide
+    auto progress = [](int interval) {
+        Voice v;
+        v.setSampleRate(kSampleRate);
+        SynthParams params;
+        params.env1Sustain = 1.0f;
+        params.driftDepth = 0.0f;
+        v.setParameters(params);
+        v.setGlideTime(0.2f);
+        v.noteOn(48, 1.0f);
+        for (int i = 0; i < 1000; ++i) v.process();
+        const float from = v.getOsc1().getFrequency();
+        v.noteOnLegato(48 + interval);
+        for (int i = 0; i < static_cast<int>(0.05f * kSampleRate); ++i) v.process();
+        return 12.0 * std::log2(v.getOsc1().getFrequency() / from) / interval;
+    };
+    const double octave = progress(12);
+    REQUIRE(octave > 0.1);
+    REQUIRE(octave < 0.9);
+    REQUIRE(progress(24) == Approx(octave).margin(1e-3));
+    REQUIRE(progress(-7) == Approx(octave).margin(1e-3));
+}
+
+TEST_CASE("Osc2 follows glide and pitch bend a fixed interval below osc1", "[voice][glide]") {
+    Voice v;
+    v.setSampleRate(kSampleRate);
+    SynthParams params;
+    params.env1Sustain = 1.0f;
+    params.driftDepth = 0.0f;
+    params.osc2Transpose = -12;
+    params.osc2Detune = 50.0f;
+    v.setParameters(params);
+    v.setGlideTime(0.1f);
+    const double interval = -12.0 + 0.5;
+
+    auto semitonesApart = [&] {
+        return 12.0 * std::log2(v.getOsc2().getFrequency() / v.getOsc1().getFrequency());
+    };
+    v.noteOn(60, 1.0f);
+    for (int i = 0; i < 2000; ++i) v.process();
+    REQUIRE(semitonesApart() == Approx(interval).margin(1e-3));
+
+    // Halfway through a glide
+    v.noteOnLegato(67);
+    for (int i = 0; i < 2000; ++i) v.process();
+    REQUIRE(semitonesApart() == Approx(interval).margin(1e-3));
+
+    // Bend moves both oscillators
+    for (int i = 0; i < static_cast<int>(kSampleRate); ++i) v.process();
+    const float osc2Before = v.getOsc2().getFrequency();
+    v.setPitchBend(2.0f);
+    for (int i = 0; i < 2000; ++i) v.process();
+    REQUIRE(v.getOsc2().getFrequency() == Approx(osc2Before * std::exp2(2.0f / 12.0f)).epsilon(1e-4));
+    REQUIRE(semitonesApart() == Approx(interval).margin(1e-3));
+}
+
 TEST_CASE("Voice with zero drift is deterministic", "[voice][drift]") {
     auto generateSamples = []() {
         Voice v;
@@ -188,3 +247,189 @@ TEST_CASE("Voice with zero drift is deterministic", "[voice][drift]") {
     float run2 = generateSamples();
     REQUIRE(run1 == Approx(run2).margin(0.001f));
 }
+
+// Render a voice with filter envelope and LFO pitch modulation at a given control block size
+static std::vector<float> renderModulatedVoice(int controlBlockSize, float sampleRate, int numSamples) {
+    Voice v;
+    v.setSampleRate(sampleRate);
+    v.setControlBlockSize(controlBlockSize);
+
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.env1Attack = 0.005f;
+    params.env1Sustain = 1.0f;
+    params.filterFreq = 800.0f;  // Env2 sweeps the cutoff (default filter mod amount)
+    params.filterRes = 0.3f;
+    v.setParameters(params);
+
+    v.noteOn(57, 1.0f);
+    std::vector<float> out(numSamples);
+    v.renderBlock(out.data(), numSamples);
+    return out;
+}
+
+TEST_CASE("Control block size is reported and clamped", "[voice][control]") {
+    Voice v;
+    REQUIRE(v.getControlBlockSize() == 1);
+    v.setControlBlockSize(32);
+    REQUIRE(v.getControlBlockSize() == 32);
+    v.setControlBlockSize(0);
+    REQUIRE(v.getControlBlockSize() == 1);
+}
+
+TEST_CASE("Control-rate modulation stays close to per-sample modulation", "[voice][control]") {
+    const int n = 9600;
+    auto exact = renderModulatedVoice(1, 96000.0f, n);
+
+    for (int blockSize : { 16, 32 }) {
+        auto coarse = renderModulatedVoice(blockSize, 96000.0f, n);
+
+        float errSq = 0.0f, refSq = 0.0f;
+        for (int i = 0; i < n; ++i) {
+            float d = coarse[i] - exact[i];
+            errSq += d * d;
+            refSq += exact[i] * exact[i];
+        }
+        // Residual well below the signal (< -30 dB)
+        REQUIRE(refSq > 0.0f);
+        REQUIRE(errSq / refSq < 1.0e-3f);
+    }
+}
+
+TEST_CASE("Control blocks carry across renderBlock calls", "[voice][control]") {
+    // Rendering in odd-sized blocks must match one sample at a time
+    auto makeVoice = [] {
+        Voice v;
+        v.setSampleRate(kSampleRate);
+        v.setControlBlockSize(16);
+        SynthParams params;
+        params.driftDepth = 0.0f;
+        params.filterFreq = 1200.0f;
+        v.setParameters(params);
+        v.noteOn(60, 1.0f);
+        return v;
+    };
+
+    Voice perSample = makeVoice();
+    Voice blocked = makeVoice();
+
+    std::vector<float> a(1000), b(1000);
+    for (auto& x : a) x = perSample.process();
+    for (int pos = 0; pos < 1000; pos += 7)
+        blocked.renderBlock(b.data() + pos, std::min(7, 1000 - pos));
+
+    for (int i = 0; i < 1000; ++i)
+        REQUIRE(b[i] == a[i]);
+}
+
+TEST_CASE("A quiet release is retired once it falls below the silence threshold", "[voice][release]") {
+    // Samples from note-off until the voice goes idle, and the loudest
+    // sample in the last 20 ms before it did
+    auto releaseLength = [](float thresholdDb, float& lastPeak) {
+        Voice v;
+        setupVoice(v);
+        SynthParams params;
+        params.env1Release = 2.0f;
+        params.driftDepth = 0.0f;
+        params.volVelMod = 1.0f;
+        v.setParameters(params);
+        v.setControlBlockSize(16);
+        v.setSilenceThreshold(thresholdDb);
+
+        v.noteOn(48, 0.05f);  // quiet note
+        for (int i = 0; i < 4410; ++i)
+            v.process();
+        v.noteOff();
+
+        std::vector<float> tail;
+        while (v.isActive() && tail.size() < 10 * 44100)
+            tail.push_back(v.process());
+        const size_t window = static_cast<size_t>(Voice::kSilenceWindowSeconds * kSampleRate);
+        lastPeak = 0.0f;
+        for (size_t i = tail.size() > window ? tail.size() - window : 0; i < tail.size(); ++i)
+            lastPeak = std::max(lastPeak, std::abs(tail[i]));
+
+        // Once retired the voice stays silent
+        for (int i = 0; i < 100; ++i)
+            REQUIRE(v.process() == 0.0f);
+        return tail.size();
+    };
+
+    float peakOff = 0.0f, peakOn = 0.0f;
+    size_t untilFloor = releaseLength(-300.0f, peakOff);  // detection off
+    size_t untilSilent = releaseLength(-60.0f, peakOn);
+
+    REQUIRE(untilSilent < untilFloor / 2);
+    REQUIRE(peakOn < std::pow(10.0f, -60.0f / 20.0f));
+    REQUIRE(peakOn > 0.0f);
+    // Without detection the envelope's own floor ends the note
+    REQUIRE(untilFloor > 2 * 44100);
+}
+
+TEST_CASE("Voice hot state fits its cache budget", "[voice][layout]") {
+    // The per-sample state of a voice pool is packed in one std::vector<Voice>;
+    // control-rate and patch state must stay out of it
+    STATIC_REQUIRE(sizeof(Voice) <= Voice::kHotBytesBudget);
+    STATIC_REQUIRE(sizeof(AnalogDrift) <= 64);
+}
+
+TEST_CASE("Copying a voice copies its control state", "[voice][layout]") {
+    Voice a;
+    setupVoice(a);
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.glideTime = 0.0f;
+    a.setParameters(params);
+    a.setGlideTime(0.1f);
+    a.noteOn(60, 1.0f);
+    for (int i = 0; i < 1000; ++i)
+        a.process();
+
+    Voice b = a;
+    REQUIRE(b.getGlideTime() == a.getGlideTime());
+    for (int i = 0; i < 1000; ++i)
+        REQUIRE(b.process() == a.process());
+
+    // The copy owns its own control state
+    b.setGlideTime(0.5f);
+    b.setDetuneOffset(20.0f);
+    REQUIRE(a.getGlideTime() == Approx(0.1f));
+    REQUIRE(a.getDetuneOffset() == 0.0f);
+}
+
+TEST_CASE("A voice taken over renders on from the same delay lines", "[voice][layout]") {
+    Voice a;
+    setupVoice(a);
+    SynthParams params;
+    params.driftDepth = 0.0f;
+    params.filterType = FilterType::Comb;
+    params.filterFreq = 200.0f;
+    params.filterRes = 0.8f;
+    a.setParameters(params);
+    a.noteOn(48, 1.0f);
+    for (int i = 0; i < 2000; ++i)
+        a.process();
+
+    // A ghost that already played something else
+    Voice ghost;
+    setupVoice(ghost);
+    ghost.setParameters(params);
+    ghost.noteOn(72, 1.0f);
+    for (int i = 0; i < 500; ++i)
+        ghost.process();
+
+    Voice reference = a;
+    Voice stopped = a;
+    ghost.takeOver(a);
+    a.stop();
+    stopped.stop();
+    for (int i = 0; i < 2000; ++i)
+        REQUIRE(ghost.process() == reference.process());
+
+    // The voice left behind holds the ghost's old delay lines, but its next
+    // note starts from clean ones
+    a.noteOn(60, 1.0f);
+    stopped.noteOn(60, 1.0f);
+    for (int i = 0; i < 2000; ++i)
+        REQUIRE(a.process() == stopped.process());
+}
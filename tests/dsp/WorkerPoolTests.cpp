@@ -0,0 +1,66 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <vector>
+#include "dsp/WorkerPool.h"
+
+using namespace vamos;
+
+namespace {
+
+struct Counts {
+    std::vector<std::atomic<int>> runs;
+    std::atomic<int> badThreadIndex { 0 };
+    int numThreads = 1;
+
+    explicit Counts(int numJobs) : runs(static_cast<size_t>(numJobs)) {}
+
+    static void job(void* context, int jobIndex, int threadIndex) {
+        auto& self = *static_cast<Counts*>(context);
+        self.runs[static_cast<size_t>(jobIndex)].fetch_add(1);
+        if (threadIndex < 0 || threadIndex >= self.numThreads)
+            self.badThreadIndex.fetch_add(1);
+    }
+};
+
+} // namespace
+
+TEST_CASE("WorkerPool runs every job exactly once", "[workers]") {
+    for (int threads : { 1, 2, 4, 8 }) {
+        WorkerPool pool;
+        pool.start(threads);
+        REQUIRE(pool.getNumThreads() == threads);
+
+        // Fewer, equal and more jobs than threads, many runs back to back
+        for (int numJobs : { 1, 3, 8, 64 }) {
+            Counts counts(numJobs);
+            counts.numThreads = threads;
+            for (int run = 0; run < 200; ++run)
+                pool.run(numJobs, &Counts::job, &counts);
+
+            for (auto& r : counts.runs)
+                REQUIRE(r.load() == 200);
+            REQUIRE(counts.badThreadIndex.load() == 0);
+        }
+    }
+}
+
+TEST_CASE("WorkerPool can be restarted and stopped", "[workers]") {
+    WorkerPool pool;
+    REQUIRE(pool.getNumThreads() == 1);
+
+    pool.start(4);
+    pool.start(2);
+    REQUIRE(pool.getNumThreads() == 2);
+
+    Counts counts(16);
+    counts.numThreads = 2;
+    pool.run(16, &Counts::job, &counts);
+    for (auto& r : counts.runs)
+        REQUIRE(r.load() == 1);
+
+    pool.stop();
+    REQUIRE(pool.getNumThreads() == 1);
+    pool.run(16, &Counts::job, &counts);
+    for (auto& r : counts.runs)
+        REQUIRE(r.load() == 2);
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/catch_approx.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/reporters/catch_reporter_event_listener.hpp>
 #include <catch2/reporters/catch_reporter_registrars.hpp>
 
@@ -7,6 +8,7 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include <string>
 
 using Catch::Approx;
 
@@ -77,6 +79,74 @@ TEST_CASE("processBlock with noteOn produces non-zero audio", "[plugin][audio]")
     REQUIRE(maxSample > 0.0f);
 }
 
+// Index of the first sample in channel 0 whose magnitude exceeds a tiny threshold
+static int firstNonSilentSample(const juce::AudioBuffer<float>& buffer) {
+    for (int i = 0; i < buffer.getNumSamples(); ++i) {
+        if (std::abs(buffer.getSample(0, i)) > 1.0e-6f)
+            return i;
+    }
+    return -1;
+}
+
+TEST_CASE("Note-on lands on its sample position within the block", "[plugin][midi][timing]") {
+    for (int offset : { 0, 37, 256, 400 }) {
+        SECTION("Offset " + std::to_string(offset)) {
+            VamosProcessor processor;
+            processor.prepareToPlay(44100.0, 512);
+
+            juce::AudioBuffer<float> buffer(2, 512);
+            juce::MidiBuffer midi;
+            midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), offset);
+
+            processor.processBlock(buffer, midi);
+
+            // Everything before the event is exact silence
+            for (int i = 0; i < offset; ++i) {
+                REQUIRE(buffer.getSample(0, i) == 0.0f);
+                REQUIRE(buffer.getSample(1, i) == 0.0f);
+            }
+
+            // The onset starts within a couple of samples of the event
+            // (the oscillators start at phase 0, so the very first sample is ~0)
+            int onset = firstNonSilentSample(buffer);
+            REQUIRE(onset >= offset);
+            REQUIRE(onset <= offset + 3);
+        }
+    }
+}
+
+TEST_CASE("Multiple events in one block are applied at their own offsets", "[plugin][midi][timing]") {
+    VamosProcessor processor;
+    processor.prepareToPlay(44100.0, 2048);
+
+    juce::AudioBuffer<float> buffer(2, 2048);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 1000);
+    midi.addEvent(juce::MidiMessage::noteOn(1, 72, 1.0f), 1500);
+
+    processor.processBlock(buffer, midi);
+
+    REQUIRE(firstNonSilentSample(buffer) >= 1000);
+    REQUIRE(firstNonSilentSample(buffer) <= 1003);
+
+    // Same block rendered with only the first note must match up to the second onset
+    VamosProcessor reference;
+    reference.prepareToPlay(44100.0, 2048);
+    juce::AudioBuffer<float> refBuffer(2, 2048);
+    juce::MidiBuffer refMidi;
+    refMidi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 1000);
+    reference.processBlock(refBuffer, refMidi);
+
+    // Analog drift is random per voice, so compare energy rather than samples
+    auto energy = [](const juce::AudioBuffer<float>& b, int start, int end) {
+        float sum = 0.0f;
+        for (int i = start; i < end; ++i) sum += b.getSample(0, i) * b.getSample(0, i);
+        return sum;
+    };
+    REQUIRE(energy(buffer, 1000, 1500) == Approx(energy(refBuffer, 1000, 1500)).epsilon(0.1));
+    REQUIRE(energy(buffer, 1500, 2048) != Approx(energy(refBuffer, 1500, 2048)).epsilon(0.01));
+}
+
 TEST_CASE("Editor creates and destroys without crash", "[plugin][editor]") {
     // This test catches the setSize() ordering bug:
     // If setSize() is called before child components are created,
@@ -131,6 +201,423 @@ TEST_CASE("State save/load round-trip preserves parameters", "[plugin][state]")
     }
 }
 
+TEST_CASE("Polyphony is applied in prepareToPlay and saved with the state", "[plugin][state]") {
+    juce::MemoryBlock savedState;
+    {
+        VamosProcessor processor;
+        processor.prepareToPlay(44100.0, 512);
+        REQUIRE(processor.getSynth().getPolyphony() == vamos::kDefaultVoices);
+
+        processor.setPolyphony(32);
+        REQUIRE(processor.getSynth().getPolyphony() == vamos::kDefaultVoices); // not yet
+        processor.prepareToPlay(44100.0, 512);
+        REQUIRE(processor.getSynth().getPolyphony() == 32);
+
+        // 24 held notes all get their own voice
+        juce::AudioBuffer<float> buffer(2, 512);
+        juce::MidiBuffer midi;
+        for (int n = 0; n < 24; ++n)
+            midi.addEvent(juce::MidiMessage::noteOn(1, 36 + n, 0.8f), n);
+        processor.processBlock(buffer, midi);
+
+        int active = 0;
+        for (const auto& v : processor.getSynth().getVoices())
+            if (v.isActive()) ++active;
+        REQUIRE(active == 24);
+
+        processor.getStateInformation(savedState);
+    }
+
+    VamosProcessor restored;
+    restored.setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+    restored.prepareToPlay(44100.0, 512);
+    REQUIRE(restored.getPolyphony() == 32);
+    REQUIRE(restored.getSynth().getPolyphony() == 32);
+}
+
+TEST_CASE("Unison stack plays a full chord with one voice per note", "[plugin][unison]") {
+    VamosProcessor processor;
+    processor.prepareToPlay(44100.0, 512);
+    processor.apvts.getParameter("voiceMode")->setValueNotifyingHost(1.0f); // Unison
+    auto* stackParam = processor.apvts.getParameter("unisonStack");
+    stackParam->setValueNotifyingHost(stackParam->convertTo0to1(8.0f));
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    for (int n = 0; n < 8; ++n)
+        midi.addEvent(juce::MidiMessage::noteOn(1, 48 + 3 * n, 0.8f), 0);
+    processor.processBlock(buffer, midi);
+
+    int active = 0;
+    for (const auto& v : processor.getSynth().getVoices()) {
+        if (!v.isActive()) continue;
+        ++active;
+        REQUIRE(v.getUnisonStackSize() == 8);
+    }
+    REQUIRE(active == 8);
+    REQUIRE(buffer.getMagnitude(0, 0, 512) > 0.0f);
+}
+
+TEST_CASE("Render threads are applied in prepareToPlay", "[plugin][threads]") {
+    VamosProcessor processor;
+    processor.prepareToPlay(44100.0, 512);
+    REQUIRE(processor.getSynth().getRenderThreads() == 1);
+
+    processor.setRenderThreads(2);
+    processor.prepareToPlay(44100.0, 512);
+    REQUIRE(processor.getSynth().getRenderThreads() == processor.getRenderThreads());
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    for (int n = 0; n < 6; ++n)
+        midi.addEvent(juce::MidiMessage::noteOn(1, 48 + n, 0.8f), 0);
+    processor.processBlock(buffer, midi);
+    REQUIRE(buffer.getMagnitude(0, 0, 512) > 0.0f);
+}
+
+static void setParameter(VamosProcessor& processor, const juce::String& id, float value) {
+    auto* param = processor.apvts.getParameter(id);
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+static int countActiveVoices(const vamos::Synth& synth) {
+    int count = 0;
+    for (const auto& v : synth.getVoices())
+        count += v.isActive() ? 1 : 0;
+    return count;
+}
+
+TEST_CASE("Parts play their own MIDI channel with their own parameters", "[plugin][parts]") {
+    auto render = [](int threads, bool partBus) {
+        auto processor = std::make_unique<VamosProcessor>();
+        processor->setNumParts(3);
+        processor->setRenderThreads(threads);
+        for (int p = 0; p < 3; ++p) {
+            processor->setPartChannel(p, p + 1);
+            // Drift is randomly seeded per voice
+            setParameter(*processor, VamosProcessor::partParameterId(p, "driftDepth"), 0.0f);
+        }
+        setParameter(*processor, VamosProcessor::partParameterId(1, "osc1Type"), 2.0f);  // sine
+        if (partBus)
+            processor->getBus(false, 1)->enable(true);
+        processor->prepareToPlay(44100.0, 512);
+
+        juce::AudioBuffer<float> buffer(partBus ? 4 : 2, 512);
+        juce::MidiBuffer midi;
+        midi.addEvent(juce::MidiMessage::noteOn(1, 48, 0.8f), 0);
+        midi.addEvent(juce::MidiMessage::noteOn(2, 60, 0.8f), 100);
+        midi.addEvent(juce::MidiMessage::noteOn(2, 64, 0.8f), 100);
+        processor->processBlock(buffer, midi);
+        return std::make_pair(std::move(processor), std::move(buffer));
+    };
+
+    auto [processor, buffer] = render(1, false);
+    REQUIRE(countActiveVoices(processor->getSynth(0)) == 1);
+    REQUIRE(countActiveVoices(processor->getSynth(1)) == 2);
+    REQUIRE(countActiveVoices(processor->getSynth(2)) == 0);
+    REQUIRE(processor->getSynth(1).getParameters().osc1Type == vamos::OscillatorType1::Sine);
+    REQUIRE(processor->getSynth(0).getParameters().osc1Type == vamos::OscillatorType1::Saw);
+
+    // Rendering the parts on several threads changes nothing
+    auto [threaded, threadedBuffer] = render(3, false);
+    for (int i = 0; i < 512; ++i)
+        REQUIRE(threadedBuffer.getSample(0, i) == buffer.getSample(0, i));
+
+    // With its output bus enabled, part 2 leaves the main mix
+    auto [routed, routedBuffer] = render(1, true);
+    REQUIRE(routedBuffer.getMagnitude(2, 0, 512) > 0.01f);
+    REQUIRE(routedBuffer.getMagnitude(0, 0, 100) > 0.01f);  // part 1 alone so far
+    float mainPlusPart = 0.0f;
+    for (int i = 0; i < 512; ++i)
+        mainPlusPart = std::max(mainPlusPart, std::abs(routedBuffer.getSample(0, i)
+            + routedBuffer.getSample(2, i) - buffer.getSample(0, i)));
+    REQUIRE(mainPlusPart < 1.0e-5f);
+
+    // Saved with the state
+    juce::MemoryBlock savedState;
+    processor->getStateInformation(savedState);
+    VamosProcessor restored;
+    restored.setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+    REQUIRE(restored.getNumParts() == 3);
+    REQUIRE(restored.getPartChannel(1) == 2);
+}
+
+TEST_CASE("Internal rate limit renders below the host rate and reports latency", "[plugin][rate]") {
+    VamosProcessor processor;
+    processor.prepareToPlay(192000.0, 512);
+    REQUIRE(processor.getLatencySamples() == 0);
+
+    processor.setInternalRateLimit(48000.0);
+    processor.prepareToPlay(192000.0, 512);
+    REQUIRE(processor.getLatencySamples() == vamos::Upsampler::kTapsPerPhase / 2 * 4);
+
+    // Odd block sizes, and one larger than prepareToPlay promised
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 3);
+    for (int blockSize : { 500, 37, 2048 }) {
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        processor.processBlock(buffer, midi);
+        midi.clear();
+        REQUIRE(buffer.getMagnitude(0, 0, blockSize) > 0.01f);
+        REQUIRE(buffer.getMagnitude(1, 0, blockSize) > 0.01f);
+    }
+
+    // Saved with the state like the pool size
+    juce::MemoryBlock savedState;
+    processor.getStateInformation(savedState);
+    VamosProcessor restored;
+    restored.setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+    restored.prepareToPlay(192000.0, 512);
+    REQUIRE(restored.getInternalRateLimit() == 48000.0);
+    REQUIRE(restored.getLatencySamples() == processor.getLatencySamples());
+}
+
+TEST_CASE("Low-latency mode moves events to control ticks and skips the upsampler", "[plugin][latency]") {
+    VamosProcessor processor;
+    processor.setInternalRateLimit(48000.0);
+    processor.setLowLatencyMode(true);
+    processor.prepareToPlay(96000.0, 16);
+    REQUIRE(processor.getLatencySamples() == 0);
+    REQUIRE(processor.getSynth().getControlBlockSize() == 16);  // 8 at 48 kHz
+
+    processor.prepareToPlay(44100.0, 512);
+    REQUIRE(processor.getSynth().getControlBlockSize() == 8);
+
+    // The event at 37 applies at the tick at 32
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 37);
+    processor.processBlock(buffer, midi);
+    int onset = firstNonSilentSample(buffer);
+    REQUIRE(onset >= 32);
+    REQUIRE(onset <= 32 + 3);
+
+    // Tiny host blocks keep rendering
+    midi.clear();
+    juce::AudioBuffer<float> small(2, 16);
+    for (int i = 0; i < 8; ++i) {
+        processor.processBlock(small, midi);
+        REQUIRE(small.getMagnitude(0, 0, 16) > 0.0f);
+    }
+
+    // Saved with the state
+    juce::MemoryBlock savedState;
+    processor.getStateInformation(savedState);
+    VamosProcessor restored;
+    restored.setStateInformation(savedState.getData(), static_cast<int>(savedState.getSize()));
+    REQUIRE(restored.isLowLatencyMode());
+}
+
+// Hidden from CTest: run with VamosPluginTests "[buffer]"
+TEST_CASE("processBlock cost vs buffer size", "[.][!benchmark][plugin][buffer]") {
+    // The same 8192 samples of a held 8-note chord at 48 kHz through
+    // processBlock, in host blocks of 16..2048 samples, with low-latency
+    // mode off and on. What the plugin adds per block (parameter snapshot,
+    // MIDI ranges, part dispatch, smoothing, micro-blocks) shows up as a
+    // rising curve at small sizes.
+    constexpr int kTotal = 8192;
+    for (bool lowLatency : { false, true }) {
+        for (int blockSize : { 16, 32, 64, 128, 256, 512, 1024, 2048 }) {
+            VamosProcessor processor;
+            processor.setLowLatencyMode(lowLatency);
+            processor.prepareToPlay(48000.0, blockSize);
+            setParameter(processor, "env1Sustain", 1.0f);
+
+            juce::AudioBuffer<float> buffer(2, blockSize);
+            juce::MidiBuffer midi;
+            for (int n = 0; n < 8; ++n)
+                midi.addEvent(juce::MidiMessage::noteOn(1, 48 + 3 * n, 0.8f), 0);
+            processor.processBlock(buffer, midi);
+            midi.clear();
+
+            const std::string name = std::string(lowLatency ? "low latency" : "default")
+                + ", " + std::to_string(blockSize) + "-sample blocks";
+            BENCHMARK(name.c_str()) {
+                for (int pos = 0; pos < kTotal; pos += blockSize)
+                    processor.processBlock(buffer, midi);
+                return buffer.getSample(0, 0);
+            };
+        }
+    }
+}
+
+TEST_CASE("Several parts render 64-bit and oversized host blocks", "[plugin][parts][double]") {
+    // Prepared for 128-sample blocks, the second processor gets 512 in
+    // double precision: it renders in 128-sample chunks into its scratch
+    auto make = [](int samplesPerBlock) {
+        auto processor = std::make_unique<VamosProcessor>();
+        processor->setNumParts(3);
+        for (int p = 0; p < 3; ++p) {
+            processor->setPartChannel(p, p + 1);
+            setParameter(*processor, VamosProcessor::partParameterId(p, "driftDepth"), 0.0f);
+        }
+        processor->prepareToPlay(44100.0, samplesPerBlock);
+        return processor;
+    };
+    auto reference = make(512);
+    auto chunked = make(128);
+
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(1, 48, 0.8f), 0);
+    midi.addEvent(juce::MidiMessage::noteOn(2, 60, 0.8f), 100);
+    midi.addEvent(juce::MidiMessage::noteOn(3, 67, 0.8f), 300);
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::AudioBuffer<double> bufferD(2, 512);
+    reference->processBlock(buffer, midi);
+    chunked->processBlock(bufferD, midi);
+
+    REQUIRE(countActiveVoices(chunked->getSynth(2)) == 1);
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 512; ++i)
+            REQUIRE(bufferD.getSample(ch, i) == Approx(buffer.getSample(ch, i)).margin(1e-6));
+    REQUIRE(bufferD.getMagnitude(0, 300, 212) > 0.01);
+}
+
+TEST_CASE("Double-precision processBlock matches the float one", "[plugin][double]") {
+    VamosProcessor single, wide;
+    REQUIRE(wide.supportsDoublePrecisionProcessing());
+    for (auto* p : { &single, &wide }) {
+        // Drift is randomly seeded per voice
+        auto* drift = p->apvts.getParameter("driftDepth");
+        drift->setValueNotifyingHost(drift->convertTo0to1(0.0f));
+        p->prepareToPlay(44100.0, 512);
+    }
+
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 10);
+    midi.addEvent(juce::MidiMessage::noteOn(1, 64, 0.7f), 300);
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::AudioBuffer<double> bufferD(2, 512);
+    single.processBlock(buffer, midi);
+    wide.processBlock(bufferD, midi);
+
+    for (int ch = 0; ch < 2; ++ch)
+        for (int i = 0; i < 512; ++i)
+            REQUIRE(bufferD.getSample(ch, i) == Approx(buffer.getSample(ch, i)).margin(1e-6));
+    REQUIRE(bufferD.getMagnitude(0, 0, 512) > 0.01);
+}
+
+TEST_CASE("Sustain pedal holds notes and re-strikes replayed ones", "[plugin][sustain]") {
+    VamosProcessor processor;
+    processor.prepareToPlay(44100.0, 512);
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::controllerEvent(1, 64, 127), 0);
+    for (int n = 0; n < 16; ++n) {
+        midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), n * 32);
+        midi.addEvent(juce::MidiMessage::noteOff(1, 60), n * 32 + 16);
+    }
+    processor.processBlock(buffer, midi);
+
+    auto sounding = [&] {
+        int count = 0;
+        for (const auto& v : processor.getSynth().getVoices())
+            count += v.isActive() && v.getAmpEnv().getStage() != vamos::Envelope::Stage::Release;
+        return count;
+    };
+    REQUIRE(processor.getSynth().isSustainPedalDown());
+    REQUIRE(sounding() == 1);
+
+    midi.clear();
+    midi.addEvent(juce::MidiMessage::controllerEvent(1, 64, 0), 0);
+    processor.processBlock(buffer, midi);
+    REQUIRE_FALSE(processor.getSynth().isSustainPedalDown());
+    REQUIRE(sounding() == 0);
+}
+
+TEST_CASE("MPE member channels bend only their own note", "[plugin][mpe]") {
+    VamosProcessor processor;
+    processor.setMpeMode(true);
+    processor.prepareToPlay(44100.0, 512);
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::pitchWheel(3, 8192 + 2048), 0);  // before its note
+    midi.addEvent(juce::MidiMessage::noteOn(2, 60, 0.8f), 0);
+    midi.addEvent(juce::MidiMessage::noteOn(3, 64, 0.8f), 0);
+    midi.addEvent(juce::MidiMessage::channelPressureChange(2, 127), 0);
+    processor.processBlock(buffer, midi);
+    midi.clear();
+    for (int b = 0; b < 10; ++b)
+        processor.processBlock(buffer, midi);
+
+    const auto& voices = processor.getSynth().getVoices();
+    REQUIRE(voices[0].getCurrentNote() == 60);
+    REQUIRE(voices[1].getCurrentNote() == 64);
+    REQUIRE(voices[0].getModContext().pressure == Approx(1.0f).margin(1e-3f));
+    REQUIRE(voices[1].getModContext().pressure == 0.0f);
+
+    // A quarter of the 48-semitone MPE range: 12 semitones up
+    const float expected = 440.0f * std::pow(2.0f, (64 + 12 - 69) / 12.0f);
+    REQUIRE(voices[1].getOsc1().getFrequency() == Approx(expected).epsilon(1e-3));
+    REQUIRE(voices[0].getOsc1().getFrequency() < 300.0f);
+}
+
+TEST_CASE("MPE note-offs and bends follow the channel, not the note number", "[plugin][mpe]") {
+    VamosProcessor processor;
+    processor.setMpeMode(true);
+    processor.prepareToPlay(44100.0, 512);
+    auto* release = processor.apvts.getParameter("env1Release");
+    release->setValueNotifyingHost(release->convertTo0to1(2.0f));
+
+    // Two member channels on the same note
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(2, 60, 0.8f), 0);
+    midi.addEvent(juce::MidiMessage::noteOn(3, 60, 0.8f), 0);
+    processor.processBlock(buffer, midi);
+    const auto& voices = processor.getSynth().getVoices();
+    const float freq = voices[0].getOsc1().getFrequency();
+
+    // Channel 2 lets go, then bends its release tail up an octave
+    midi.clear();
+    midi.addEvent(juce::MidiMessage::noteOff(2, 60), 0);
+    midi.addEvent(juce::MidiMessage::pitchWheel(2, 8192 + 2048), 0);
+    processor.processBlock(buffer, midi);
+    midi.clear();
+    for (int b = 0; b < 10; ++b)
+        processor.processBlock(buffer, midi);
+
+    REQUIRE(voices[0].isActive());
+    REQUIRE(voices[0].getAmpEnv().getStage() == vamos::Envelope::Stage::Release);
+    REQUIRE(voices[1].getAmpEnv().getStage() != vamos::Envelope::Stage::Release);
+    REQUIRE(voices[0].getOsc1().getFrequency() == Approx(2.0f * freq).epsilon(1e-3));
+    REQUIRE(voices[1].getOsc1().getFrequency() == Approx(freq).epsilon(1e-6));
+}
+
+TEST_CASE("Tail length follows the release and the synth falls silent within it", "[plugin][tail]") {
+    VamosProcessor processor;
+    processor.prepareToPlay(44100.0, 512);
+    auto* release = processor.apvts.getParameter("env1Release");
+
+    release->setValueNotifyingHost(release->convertTo0to1(0.2f));
+    const double shortTail = processor.getTailLengthSeconds();
+    release->setValueNotifyingHost(release->convertTo0to1(0.5f));
+    const double tail = processor.getTailLengthSeconds();
+    REQUIRE(shortTail > 0.2);
+    REQUIRE(tail > shortTail);
+
+    juce::AudioBuffer<float> buffer(2, 512);
+    juce::MidiBuffer midi;
+    midi.addEvent(juce::MidiMessage::noteOn(1, 60, 0.8f), 0);
+    processor.processBlock(buffer, midi);
+    midi.clear();
+    midi.addEvent(juce::MidiMessage::noteOff(1, 60), 0);
+    processor.processBlock(buffer, midi);
+    midi.clear();
+
+    // Silent (and no longer rendering) within the reported tail
+    int blocks = 0;
+    while (!processor.getSynth().isSilent() && blocks < 1000) {
+        processor.processBlock(buffer, midi);
+        ++blocks;
+    }
+    REQUIRE(blocks * 512 <= static_cast<int>(tail * 44100.0) + 512);
+    processor.processBlock(buffer, midi);
+    REQUIRE(buffer.getMagnitude(0, 0, 512) == 0.0f);
+}
+
 TEST_CASE("Parameter layout has expected number of parameters", "[plugin][params]") {
     VamosProcessor processor;
 